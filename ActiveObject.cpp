@@ -1,68 +1,133 @@
 // ActiveObject.cpp
 #include "ActiveObject.h"
-#include <iostream>
+#include "Logger.h"
+#include <chrono>
 
-ActiveObject::ActiveObject(int id) : stop(false), threadID(id)
+namespace
+{
+    // Mailbox slots per stage; producers wait (yielding) while it is full
+    const size_t MAILBOX_CAPACITY = 1024;
+
+    // Rounds of polling an empty mailbox before the stage parks
+    const int SPIN_ROUNDS = 64;
+}
+
+ActiveObject::ActiveObject(int id)
+    : tasks(MAILBOX_CAPACITY), parked(false), stop(false), enqueuedTasks(0), completedTasks(0), busyNanoseconds(0),
+      threadID(id)
 {
     worker = std::thread(&ActiveObject::run, this);
 }
 
+/**
+ * @brief Stops the thread once every task enqueued so far has run.
+ */
 ActiveObject::~ActiveObject()
 {
+    stop.store(true, std::memory_order_seq_cst);
     {
-        std::unique_lock<std::mutex> lock(mutex);
-        stop = true;
+        std::lock_guard<std::mutex> lock(parkMutex);
+        parkCondition.notify_all();
     }
-    cv.notify_all();
     worker.join();
 }
 
 /**
- * @brief Adds a task to the task queue for the ActiveObject thread to execute.
+ * @brief Adds a task to the mailbox for the ActiveObject thread to execute.
  *
- * This function adds a task to the task queue and notifies the ActiveObject thread
- * that a new task is available. If the stop flag is set, it is not possible to enqueue
- * new tasks.
+ * The task is moved into a free slot of the ring; if the ring is full the
+ * caller yields until the stage frees one. The stage is only notified through
+ * the condition variable when it is parked.
  *
  * @param task The task to enqueue.
+ */
+void ActiveObject::enqueue(Task task)
+{
+    enqueuedTasks.fetch_add(1, std::memory_order_relaxed);
+    while (!tasks.tryPush(task))
+        std::this_thread::yield();
+    wake();
+}
+
+size_t ActiveObject::getQueueDepth() const
+{
+    uint64_t completed = completedTasks.load(std::memory_order_relaxed);
+    uint64_t enqueued = enqueuedTasks.load(std::memory_order_relaxed);
+    return enqueued > completed ? static_cast<size_t>(enqueued - completed) : 0;
+}
+
+uint64_t ActiveObject::getCompletedTasks() const
+{
+    return completedTasks.load(std::memory_order_relaxed);
+}
+
+uint64_t ActiveObject::getBusyNanoseconds() const
+{
+    return busyNanoseconds.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Wakes the stage if it is parked.
  *
- * @exception std::runtime_error If the stop flag is set.
+ * The fence pairs with the one in run(): either the stage sees the new task
+ * before it parks, or this sees 'parked' set and notifies it under the lock.
  */
-void ActiveObject::enqueue(std::function<void()> task)
+void ActiveObject::wake()
 {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (parked.load(std::memory_order_relaxed))
     {
-        std::unique_lock<std::mutex> lock(mutex);
-        tasks.push(task);
+        std::lock_guard<std::mutex> lock(parkMutex);
+        parkCondition.notify_one();
     }
-    cv.notify_one();
 }
 
 /**
  * @brief The main loop of the ActiveObject thread.
  *
- * This function is where the thread spends most of its time. It waits for tasks to be
- * added to the queue and then executes them. If the stop flag is set and the queue is
- * empty, the thread exits.
+ * Runs tasks while the mailbox has any. When it is empty the thread polls it
+ * for SPIN_ROUNDS rounds, so a task handed over by the previous stage shortly
+ * after is picked up without a context switch, and then parks. If the stop
+ * flag is set and the mailbox is empty, the thread exits.
  */
 void ActiveObject::run()
 {
-    std::cout << "ActiveObject Thread " << threadID << " started.\n";
+    LOG_DEBUG("ActiveObject Thread " << threadID << " started.");
+    int idleRounds = 0;
+    Task task;
     while (true)
     {
-        std::function<void()> task;
+        if (tasks.tryPop(task))
         {
-            std::unique_lock<std::mutex> lock(mutex);
-            cv.wait(lock, [this]()
-                    { return stop || !tasks.empty(); });
-            if (stop && tasks.empty())
-            {
-                std::cout << "ActiveObject Thread " << threadID << " stopping.\n";
-                return;
-            }
-            task = tasks.front();
-            tasks.pop();
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            task();
+            task.reset(); // Release the captured state before waiting for more
+            std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+            busyNanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+                                      std::memory_order_relaxed);
+            completedTasks.fetch_add(1, std::memory_order_relaxed);
+            idleRounds = 0;
+            continue;
         }
-        std::cout << "ActiveObject Thread " << threadID << " executing task.\n";
-        task();
+
+        if (stop.load(std::memory_order_acquire) && tasks.empty())
+        {
+            LOG_DEBUG("ActiveObject Thread " << threadID << " stopping.");
+            return;
+        }
+
+        if (++idleRounds < SPIN_ROUNDS)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(parkMutex);
+        parked.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        parkCondition.wait(lock, [this]()
+                           { return !tasks.empty() || stop.load(std::memory_order_acquire); });
+        parked.store(false, std::memory_order_relaxed);
+        idleRounds = 0;
     }
 }
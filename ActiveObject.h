@@ -3,26 +3,46 @@
 #define ACTIVEOBJECT_H
 
 #include <thread>
-#include <queue>
 #include <mutex>
 #include <condition_variable>
-#include <functional>
 #include <atomic>
+#include <cstdint>
+#include "Task.h"
+#include "MPSCQueue.h"
 
+/**
+ * @brief A thread with a mailbox: tasks enqueued from any thread run on it one
+ * at a time, in order.
+ *
+ * The mailbox is a bounded lock-free ring of Tasks, so handing a task to a
+ * stage neither locks nor allocates. An idle stage spins briefly before it
+ * parks on a condition variable, which keeps the hand-off latency between busy
+ * pipeline stages low; producers only touch the lock when the stage is parked.
+ */
 class ActiveObject
 {
 public:
     ActiveObject(int id); // Constructor with thread ID
     ~ActiveObject();
-    void enqueue(std::function<void()> task);
+    void enqueue(Task task);
+
+    size_t getQueueDepth() const;        // Tasks enqueued and not finished yet, including a running one
+    uint64_t getCompletedTasks() const;
+    uint64_t getBusyNanoseconds() const; // Total time spent running tasks
 
 private:
     void run();
+    void wake();
+
+    MPSCQueue<Task> tasks;
     std::thread worker;
-    std::queue<std::function<void()>> tasks;
-    std::mutex mutex;
-    std::condition_variable cv;
-    bool stop;
+    std::mutex parkMutex;
+    std::condition_variable parkCondition;
+    std::atomic<bool> parked;
+    std::atomic<bool> stop;
+    std::atomic<uint64_t> enqueuedTasks;
+    std::atomic<uint64_t> completedTasks;
+    std::atomic<uint64_t> busyNanoseconds;
     int threadID; // Thread identifier
 };
 
@@ -0,0 +1,150 @@
+// AlgorithmSelector.cpp
+#include "AlgorithmSelector.h"
+#include "PrimAlgorithm.h"
+#include "DensePrimAlgorithm.h"
+#include "ParallelFor.h"
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+// Indices into KERNELS, for the cost model
+namespace
+{
+    enum
+    {
+        PRIM,
+        PRIM_HEAP,
+        KRUSKAL,
+        BORUVKA,
+        FILTER_KRUSKAL,
+        DENSE_PRIM
+    };
+}
+
+const char *const AlgorithmSelector::KERNELS[NUM_KERNELS] = {"Prim", "PrimHeap", "Kruskal", "Boruvka", "FilterKruskal",
+                                                                      "DensePrim"};
+
+AlgorithmSelector::ClassKey AlgorithmSelector::classify(const CSRGraph &graph)
+{
+    double V = std::max(graph.getNumVertices(), 1);
+    double E = static_cast<double>(graph.getNumEdges());
+    return ClassKey(static_cast<int>(std::log2(E + 1)), static_cast<int>(std::log2(2 * E / V + 1)),
+                    static_cast<int>(graph.getWeightType()));
+}
+
+// What the kernels' running times are proportional to, roughly: vertices plus adjacency entries
+double AlgorithmSelector::elements(const CSRGraph &graph)
+{
+    return graph.getNumVertices() + 2.0 * graph.getNumEdges() + 1;
+}
+
+/**
+ * Rough running time of a kernel in nanoseconds, fitted to random graphs with
+ * 1M vertices and 8M edges on one core. Only the ranking matters, and only
+ * until the kernel has been measured in the graph's size class.
+ */
+double AlgorithmSelector::modelNanoseconds(const CSRGraph &graph, int kernel)
+{
+    double V = graph.getNumVertices();
+    double E = static_cast<double>(graph.getNumEdges());
+    double entries = 2 * E;
+    double logV = std::log2(std::max(V, 2.0));
+    double logEntries = std::log2(std::max(entries, 2.0));
+    double cores = parallelWorkerCount();
+    bool fourByteWeights = graph.getWeightType() != WeightType::Double;
+
+    switch (kernel)
+    {
+    case PRIM:
+        // Bucket queue for small integer weights, otherwise one heap push per entry
+        if (graph.getWeightType() == WeightType::UInt32 &&
+            graph.getMaxIntegerWeight() <= PrimAlgorithm::BUCKET_QUEUE_MAX_WEIGHT)
+            return entries * 35 + V * 20 + graph.getMaxIntegerWeight();
+        return entries * (20 + 8 * logEntries);
+    case PRIM_HEAP:
+        // At most V heap entries, one decrease-key per improving entry
+        return entries * 25 + V * 12 * logV / 2;
+    case KRUSKAL:
+        // Collecting plus radix or comparison sort, then a union-find scan
+        return E * (fourByteWeights ? 60 : 30 + 4 * logEntries) + V * 10;
+    case BORUVKA:
+        // Every round scans all entries in parallel; the components at least halve per round
+        return (entries * 8 + V * 15) * (logV / 2 + 1) / cores;
+    case FILTER_KRUSKAL:
+        // Parallel partitioning and filtering, with a sequential Kruskal on the light part
+        return entries * 20 / cores + V * logV * 10;
+    default:
+        // One streaming pass over the rows plus V vectorized scans of the key array; only for dense graphs
+        if (!DensePrimAlgorithm::isDenseEnough(graph))
+            return std::numeric_limits<double>::infinity();
+        return entries * 3 + V * V / 2;
+    }
+}
+
+bool AlgorithmSelector::spansWholeForest(const std::string &name)
+{
+    return name != KERNELS[PRIM] && name != KERNELS[PRIM_HEAP] && name != KERNELS[DENSE_PRIM];
+}
+
+AlgorithmChoice AlgorithmSelector::choose(const CSRGraph &graph, bool wholeForestOnly)
+{
+    double estimates[NUM_KERNELS];
+    for (int kernel = 0; kernel < NUM_KERNELS; ++kernel)
+    {
+        if (wholeForestOnly && !spansWholeForest(KERNELS[kernel]))
+            estimates[kernel] = std::numeric_limits<double>::infinity(); // Ruled out like an unfit kernel
+        else
+            estimates[kernel] = modelNanoseconds(graph, kernel);
+    }
+    ClassKey key = classify(graph);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    SizeClass &sizeClass = classes[key];
+    ++sizeClass.requests;
+
+    int best = 0;
+    for (int kernel = 0; kernel < NUM_KERNELS; ++kernel)
+    {
+        const KernelStatistics &statistics = sizeClass.kernels[kernel];
+        if (statistics.runs > 0 && std::isfinite(estimates[kernel]))
+            estimates[kernel] = statistics.nanosecondsPerElement * elements(graph);
+        if (estimates[kernel] < estimates[best])
+            best = kernel;
+    }
+
+    // Now and then measure the kernel we know least about, as long as it could plausibly win
+    int picked = best;
+    if (sizeClass.requests % EXPLORE_INTERVAL == 0)
+    {
+        for (int kernel = 0; kernel < NUM_KERNELS; ++kernel)
+        {
+            if (estimates[kernel] <= estimates[best] * EXPLORE_MARGIN &&
+                sizeClass.kernels[kernel].runs < sizeClass.kernels[picked].runs)
+                picked = kernel;
+        }
+    }
+
+    AlgorithmChoice choice;
+    choice.name = KERNELS[picked];
+    choice.estimatedMilliseconds = estimates[picked] / 1e6;
+    choice.measuredRuns = sizeClass.kernels[picked].runs;
+    choice.exploring = picked != best;
+    return choice;
+}
+
+void AlgorithmSelector::recordRuntime(const CSRGraph &graph, const std::string &name, double seconds)
+{
+    int kernel = std::find(KERNELS, KERNELS + NUM_KERNELS, name) - KERNELS;
+    if (kernel == NUM_KERNELS)
+        return;
+    double perElement = seconds * 1e9 / elements(graph);
+    ClassKey key = classify(graph);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    KernelStatistics &statistics = classes[key].kernels[kernel];
+    if (statistics.runs == 0)
+        statistics.nanosecondsPerElement = perElement;
+    else
+        statistics.nanosecondsPerElement += SMOOTHING * (perElement - statistics.nanosecondsPerElement);
+    ++statistics.runs;
+}
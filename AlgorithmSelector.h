@@ -0,0 +1,78 @@
+// AlgorithmSelector.h
+#ifndef ALGORITHMSELECTOR_H
+#define ALGORITHMSELECTOR_H
+
+#include <string>
+#include <map>
+#include <tuple>
+#include <mutex>
+#include <cstdint>
+#include "CSRGraph.h"
+
+// The kernel picked for one graph and why
+struct AlgorithmChoice
+{
+    std::string name;
+    double estimatedMilliseconds = 0.0;
+    unsigned measuredRuns = 0; // Runs of this kernel in the graph's size class; 0 means the estimate is the cost model's
+    bool exploring = false;    // Picked to measure it, not because it is the cheapest known
+};
+
+/**
+ * @brief Picks the MST kernel for a graph and learns from how long it took.
+ *
+ * Graphs fall into size classes by the magnitude of E, the magnitude of the
+ * average degree and the weight type. Within a class every kernel starts with
+ * a cost model estimate (from V, E, whether its bucket queue, radix sort or
+ * dense scan applies, and the cores the parallel kernels can use) and,
+ * once it has run, uses its measured time per vertex and edge instead, as a
+ * moving average. A kernel the model rules out for a graph stays ruled out.
+ * The cheapest estimate wins, except that every EXPLORE_INTERVAL-th request
+ * of a class runs the least measured kernel that is within EXPLORE_MARGIN of
+ * it, so a cost model that is wrong for this machine gets corrected.
+ *
+ * The Prim kernels span only the component of vertex 0, the others the whole
+ * forest; on a graph known to be disconnected only the latter are candidates.
+ *
+ * Thread-safe.
+ */
+class AlgorithmSelector
+{
+public:
+    static const int NUM_KERNELS = 6;
+    static const char *const KERNELS[NUM_KERNELS]; // MSTFactory names of the candidates
+
+    // Whether the kernel spans every component of a disconnected graph, not only vertex 0's
+    static bool spansWholeForest(const std::string &name);
+
+    AlgorithmChoice choose(const CSRGraph &graph, bool wholeForestOnly = false);
+    void recordRuntime(const CSRGraph &graph, const std::string &name, double seconds);
+
+private:
+    static const unsigned EXPLORE_INTERVAL = 8;
+    static constexpr double EXPLORE_MARGIN = 3.0;  // Times the best estimate
+    static constexpr double SMOOTHING = 0.3;       // Weight of the newest run in the moving average
+
+    struct KernelStatistics
+    {
+        unsigned runs = 0;
+        double nanosecondsPerElement = 0.0; // Per vertex and adjacency entry
+    };
+
+    struct SizeClass
+    {
+        uint64_t requests = 0;
+        KernelStatistics kernels[NUM_KERNELS];
+    };
+
+    typedef std::tuple<int, int, int> ClassKey; // log2 of E, log2 of the average degree, weight type
+
+    static ClassKey classify(const CSRGraph &graph);
+    static double elements(const CSRGraph &graph);
+    static double modelNanoseconds(const CSRGraph &graph, int kernel);
+
+    std::mutex mutex;
+    std::map<ClassKey, SizeClass> classes;
+};
+
+#endif // ALGORITHMSELECTOR_H
@@ -0,0 +1,91 @@
+// AutoAlgorithm.cpp
+#include "AutoAlgorithm.h"
+#include "MSTFactory.h"
+#include "ParallelFor.h"
+#include <memory>
+#include <chrono>
+#include <cstdio>
+
+namespace
+{
+    const char *weightTypeName(WeightType type)
+    {
+        switch (type)
+        {
+        case WeightType::UInt32:
+            return "integer";
+        case WeightType::Float:
+            return "float";
+        default:
+            return "double";
+        }
+    }
+}
+
+// Notes the kernel Auto picked in the trace and runs it; 'seconds' receives its runtime
+std::vector<Edge> AutoAlgorithm::runChoice(const CSRGraph &graph, const AlgorithmChoice &choice,
+                                           ComputationTrace &trace, double &seconds)
+{
+    selected = choice.name;
+
+    char estimate[64];
+    std::snprintf(estimate, sizeof(estimate), "%.3g ms", choice.estimatedMilliseconds);
+    trace.note("Auto selected ", selected, " for ", graph.getNumVertices(), " vertices and ", graph.getNumEdges(),
+               " edges (average degree ",
+               graph.getNumVertices() == 0 ? 0.0 : 2.0 * graph.getNumEdges() / graph.getNumVertices(), ", ",
+               weightTypeName(graph.getWeightType()), " weights, ", parallelWorkerCount(), " cores): ",
+               choice.exploring ? "measuring it, estimated " : "estimated ", estimate,
+               choice.measuredRuns == 0 ? std::string(" by the cost model.")
+                                        : " from " + std::to_string(choice.measuredRuns) + " runs.");
+
+    std::unique_ptr<MSTAlgorithm> kernel(MSTFactory::createAlgorithm(selected));
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<Edge> mstEdges = kernel->computeMST(graph, trace);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    seconds = elapsed.count();
+    return mstEdges;
+}
+
+/**
+ * @brief Computes the MST with the kernel that is expected to be fastest on this graph.
+ *
+ * The candidates do not all cover the same vertices of a disconnected graph:
+ * the Prim kernels span the component of vertex 0, the others the whole
+ * forest. So that the result does not depend on the pick, a Prim kernel that
+ * ends short of a spanning tree is followed by the fastest whole-forest
+ * kernel, whose forest is the result; the Prim kernel is charged for both
+ * runs, so graphs like this one learn to avoid it.
+ *
+ * The runtimes are recorded for later choices, except under a full trace,
+ * where streaming the steps to the client dominates them.
+ *
+ * @param graph The input graph in compressed-sparse-row form.
+ * @param trace Receives the choices and the selected kernels' steps.
+ *
+ * @return A vector of edges representing the minimum spanning forest of the input graph.
+ */
+std::vector<Edge> AutoAlgorithm::computeMST(const CSRGraph &graph, ComputationTrace &trace)
+{
+    bool record = trace.getLevel() != TraceLevel::Full;
+    double seconds;
+    std::vector<Edge> mstEdges = runChoice(graph, MSTFactory::chooseAlgorithm(graph), trace, seconds);
+    if (mstEdges.size() + 1 >= static_cast<size_t>(graph.getNumVertices()) ||
+        AlgorithmSelector::spansWholeForest(selected))
+    {
+        if (record)
+            MSTFactory::recordRuntime(graph, selected, seconds);
+        return mstEdges;
+    }
+
+    trace.note(selected, " spanned only the component of vertex 0 (", mstEdges.size() + 1, " of ",
+               graph.getNumVertices(), " vertices); the graph is disconnected, so Auto runs a whole-forest kernel.");
+    std::string partial = selected;
+    double forestSeconds;
+    mstEdges = runChoice(graph, MSTFactory::chooseAlgorithm(graph, true), trace, forestSeconds);
+    if (record)
+    {
+        MSTFactory::recordRuntime(graph, partial, seconds + forestSeconds);
+        MSTFactory::recordRuntime(graph, selected, forestSeconds);
+    }
+    return mstEdges;
+}
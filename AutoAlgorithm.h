@@ -0,0 +1,21 @@
+// AutoAlgorithm.h
+#ifndef AUTOALGORITHM_H
+#define AUTOALGORITHM_H
+
+#include "MSTAlgorithm.h"
+#include "AlgorithmSelector.h"
+
+// Runs the kernel MSTFactory::chooseAlgorithm() picks for the graph and reports its runtime back;
+// its result spans every component of a disconnected graph, whichever kernel it picks
+class AutoAlgorithm : public MSTAlgorithm {
+public:
+    std::vector<Edge> computeMST(const CSRGraph& graph, ComputationTrace& trace) override;
+    std::string getName() const override { return selected.empty() ? "Auto" : selected; }
+private:
+    std::vector<Edge> runChoice(const CSRGraph& graph, const AlgorithmChoice& choice, ComputationTrace& trace,
+                                double& seconds);
+
+    std::string selected;
+};
+
+#endif // AUTOALGORITHM_H
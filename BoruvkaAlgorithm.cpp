@@ -0,0 +1,133 @@
+// BoruvkaAlgorithm.cpp
+#include "BoruvkaAlgorithm.h"
+#include "ConcurrentDisjointSet.h"
+#include "ParallelFor.h"
+#include <algorithm>
+
+namespace
+{
+    // Sentinel for "no outgoing edge found"
+    const size_t NO_EDGE = static_cast<size_t>(-1);
+
+    /**
+     * Strict total order on CSR entries: by weight, then by the (smaller, larger)
+     * endpoint pair. Ties between equal weights must be broken the same way by
+     * every component, otherwise two components could pick different equal-weight
+     * edges towards each other and close a cycle.
+     */
+    bool lighter(const CSRGraph &graph, int u1, size_t i1, int u2, size_t i2)
+    {
+        double w1 = graph.weight(i1), w2 = graph.weight(i2);
+        if (w1 != w2)
+            return w1 < w2;
+        int v1 = graph.neighbor(i1), v2 = graph.neighbor(i2);
+        int a1 = std::min(u1, v1), b1 = std::max(u1, v1);
+        int a2 = std::min(u2, v2), b2 = std::max(u2, v2);
+        if (a1 != a2)
+            return a1 < a2;
+        return b1 < b2;
+    }
+}
+
+/**
+ * @brief Computes the Minimum Spanning Tree (MST) of a graph using Boruvka's algorithm.
+ *
+ * Every round, each component picks the cheapest edge leaving it and all those
+ * edges are contracted at once, so the number of components at least halves per
+ * round and there are at most log2(V) rounds.
+ *
+ * The expensive part of a round, scanning all E edges, is split across cores:
+ * each worker finds the cheapest outgoing edge of every vertex in its slice of
+ * the vertex range. A short sequential pass then reduces the per-vertex minima
+ * to per-component minima. The contraction runs in parallel again on a shared
+ * lock-free disjoint set: the chosen edges form a forest, so every unite
+ * succeeds except for an edge picked by both of its components.
+ *
+ * @param graph The input graph in compressed-sparse-row form.
+ * @param trace Receives one note per round and every included edge.
+ *
+ * @return A vector of edges representing the MST of the input graph.
+ */
+std::vector<Edge> BoruvkaAlgorithm::computeMST(const CSRGraph &graph, ComputationTrace &trace)
+{
+    int V = graph.getNumVertices();
+    std::vector<Edge> mstEdges;
+    ConcurrentDisjointSet ds(V);
+    std::vector<std::vector<Edge>> workerEdges(parallelWorkerCount()); // Edges contracted by each worker
+
+    std::vector<int> component(V);        // Component (set representative) of each vertex this round
+    std::vector<size_t> vertexBest(V);    // Cheapest outgoing CSR entry of each vertex
+    std::vector<int> componentBest(V, -1); // Vertex holding the cheapest outgoing entry of each component
+
+    trace.note("Starting Boruvka's algorithm with ", parallelWorkerCount(), " worker threads:");
+
+    int round = 0;
+    bool merged = true;
+    while (merged && mstEdges.size() + 1 < static_cast<size_t>(V))
+    {
+        merged = false;
+        ++round;
+
+        parallelFor(0, V, [&](size_t begin, size_t end, unsigned)
+                    {
+            for (size_t u = begin; u < end; ++u)
+                component[u] = ds.find(u); });
+
+        // Parallel phase: cheapest edge from every vertex to another component
+        parallelFor(0, V, [&](size_t begin, size_t end, unsigned)
+                    {
+            for (size_t u = begin; u < end; ++u)
+            {
+                size_t best = NO_EDGE;
+                for (size_t i = graph.begin(u); i < graph.end(u); ++i)
+                {
+                    if (component[graph.neighbor(i)] == component[u])
+                        continue;
+                    if (best == NO_EDGE || lighter(graph, u, i, u, best))
+                        best = i;
+                }
+                vertexBest[u] = best;
+            } });
+
+        // Reduce the per-vertex minima to one candidate per component
+        std::fill(componentBest.begin(), componentBest.end(), -1);
+        for (int u = 0; u < V; ++u)
+        {
+            if (vertexBest[u] == NO_EDGE)
+                continue;
+            int &holder = componentBest[component[u]];
+            if (holder == -1 || lighter(graph, u, vertexBest[u], holder, vertexBest[holder]))
+                holder = u;
+        }
+
+        // Parallel phase: contract every component along its cheapest edge
+        parallelFor(0, V, [&](size_t begin, size_t end, unsigned worker)
+                    {
+            for (size_t c = begin; c < end; ++c)
+            {
+                int u = componentBest[c];
+                if (u == -1)
+                    continue;
+                size_t i = vertexBest[u];
+                int v = graph.neighbor(i);
+                // Two components may have chosen the same edge; only one unite succeeds
+                if (ds.unite(u, v))
+                    workerEdges[worker].emplace_back(u, v, graph.weight(i));
+            } });
+
+        size_t contracted = mstEdges.size();
+        for (auto &edges : workerEdges)
+        {
+            for (const auto &edge : edges)
+            {
+                mstEdges.push_back(edge);
+                trace.event(TraceEvent::Include, edge);
+            }
+            merged = merged || !edges.empty();
+            edges.clear();
+        }
+        trace.note("Round ", round, ": contracted ", mstEdges.size() - contracted, " edges.");
+    }
+
+    return mstEdges;
+}
@@ -0,0 +1,13 @@
+// BoruvkaAlgorithm.h
+#ifndef BORUVKAALGORITHM_H
+#define BORUVKAALGORITHM_H
+
+#include "MSTAlgorithm.h"
+
+class BoruvkaAlgorithm : public MSTAlgorithm {
+public:
+    std::vector<Edge> computeMST(const CSRGraph& graph, ComputationTrace& trace) override;
+    std::string getName() const override { return "Boruvka"; }
+};
+
+#endif // BORUVKAALGORITHM_H
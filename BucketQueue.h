@@ -0,0 +1,93 @@
+// BucketQueue.h
+#ifndef BUCKETQUEUE_H
+#define BUCKETQUEUE_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Min-priority queue over the item ids 0..n-1 with integer keys
+ * 0..maxKey, as one bucket per key (Dial's algorithm); same interface as
+ * IndexedDaryHeap.
+ *
+ * The buckets are intrusive doubly linked lists threaded through per-item
+ * arrays, so push, decreaseKey and removal are O(1) and never allocate. pop()
+ * scans upwards from the lowest bucket that may be non-empty; a push below it
+ * moves it down again. That makes it fast when the keys are small integers,
+ * and slow when maxKey is much larger than the number of items.
+ */
+class IndexedBucketQueue
+{
+public:
+    IndexedBucketQueue(int n, uint32_t maxKey)
+        : head(static_cast<size_t>(maxKey) + 1, NONE), next(n, NONE), previous(n, NONE), keys(n),
+          inQueue(n, false), lowest(0), count(0)
+    {
+    }
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+    bool contains(int item) const { return inQueue[item]; }
+    uint32_t key(int item) const { return keys[item]; }
+
+    // Inserts an item that is not in the queue yet
+    void push(int item, uint32_t key)
+    {
+        keys[item] = key;
+        inQueue[item] = true;
+        previous[item] = NONE;
+        next[item] = head[key];
+        if (head[key] != NONE)
+            previous[head[key]] = item;
+        head[key] = item;
+        if (key < lowest)
+            lowest = key;
+        ++count;
+    }
+
+    // Lowers the key of an item that is already in the queue
+    void decreaseKey(int item, uint32_t key)
+    {
+        unlink(item);
+        push(item, key);
+    }
+
+    // Removes and returns an item with the smallest key
+    int pop()
+    {
+        while (head[lowest] == NONE)
+            ++lowest;
+        int item = head[lowest];
+        unlink(item);
+        return item;
+    }
+
+private:
+    enum
+    {
+        NONE = -1 // No item
+    };
+
+    void unlink(int item)
+    {
+        if (previous[item] != NONE)
+            next[previous[item]] = next[item];
+        else
+            head[keys[item]] = next[item];
+        if (next[item] != NONE)
+            previous[next[item]] = previous[item];
+        inQueue[item] = false;
+        --count;
+    }
+
+    std::vector<int> head;     // First item of every bucket
+    std::vector<int> next;     // Neighbours of every item in its bucket
+    std::vector<int> previous;
+    std::vector<uint32_t> keys; // Current key of every item
+    std::vector<bool> inQueue;
+    uint32_t lowest; // No bucket below this one holds an item
+    size_t count;
+};
+
+#endif // BUCKETQUEUE_H
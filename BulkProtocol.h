@@ -0,0 +1,52 @@
+// BulkProtocol.h
+#ifndef BULKPROTOCOL_H
+#define BULKPROTOCOL_H
+
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Binary bulk upload of a whole graph, shared by the server and the client.
+ *
+ * At the main menu, instead of choosing option 1 and typing every edge, a
+ * client may send a BulkHeader followed by numEdges BulkEdge records, with no
+ * newlines or other separators. The server recognizes the upload by the magic
+ * at the start of a command while the client is at the main menu; the magic
+ * starts with a byte that never begins a text line (0xFF is not valid in
+ * UTF-8), so typed input is never mistaken for an upload. The server receives
+ * the records straight into one array and
+ * replaces the current graph with them, exactly as if they had been entered
+ * one by one with option 1 (vertices are numbered from 0).
+ *
+ * All fields are in the byte order of the machine (little-endian on x86), with
+ * the sizes and offsets fixed by the static_asserts below.
+ */
+
+static const char BULK_MAGIC[4] = {'\xFF', 'M', 'S', 'T'};
+
+// Uploads above this many edges are always refused (2 GiB of records); a server may set a lower limit
+static const int64_t BULK_MAX_EDGES = int64_t(1) << 27;
+
+struct BulkHeader
+{
+    char magic[4];       // BULK_MAGIC
+    int32_t numVertices; // n
+    int64_t numEdges;    // m, the number of records that follow
+};
+
+struct BulkEdge
+{
+    int32_t src;
+    int32_t dest;
+    double weight;
+};
+
+static_assert(sizeof(BulkHeader) == 16, "BulkHeader must be 16 bytes without padding");
+static_assert(sizeof(BulkEdge) == 16, "BulkEdge must be 16 bytes without padding");
+
+inline bool isBulkMagic(const char *data)
+{
+    return std::memcmp(data, BULK_MAGIC, sizeof(BULK_MAGIC)) == 0;
+}
+
+#endif // BULKPROTOCOL_H
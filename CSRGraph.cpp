@@ -0,0 +1,133 @@
+// CSRGraph.cpp
+#include "CSRGraph.h"
+#include "Graph.h"
+#include <utility>
+#include <limits>
+
+/**
+ * @brief Builds the CSR arrays from the adjacency lists of a mutable Graph.
+ *
+ * The row of every vertex keeps the order of its adjacency list, so the
+ * algorithms visit neighbors in the same order as before.
+ */
+CSRGraph::CSRGraph(const Graph &graph)
+    : V(graph.getNumVertices()), version(graph.getVersion()), ownOffsets(V + 1, 0)
+{
+    for (int u = 0; u < V; ++u)
+        ownOffsets[u + 1] = ownOffsets[u] + graph.getAdjEdges(u).size();
+
+    ownNeighbors.reserve(ownOffsets[V]);
+    ownWeights.reserve(ownOffsets[V]);
+    for (int u = 0; u < V; ++u)
+    {
+        for (const auto &edge : graph.getAdjEdges(u))
+        {
+            ownNeighbors.push_back(edge.dest);
+            ownWeights.push_back(edge.weight);
+        }
+    }
+    attachOwnArrays();
+}
+
+/**
+ * @brief Builds the CSR arrays directly from a list of undirected edges.
+ *
+ * Uses a counting pass over the endpoints followed by a scatter pass, so the
+ * edge list is read twice and no intermediate adjacency lists are allocated.
+ */
+CSRGraph::CSRGraph(int numVertices, const std::vector<Edge> &edges)
+    : V(numVertices), version(0), ownOffsets(numVertices + 1, 0), ownNeighbors(edges.size() * 2),
+      ownWeights(edges.size() * 2)
+{
+    // Count the degree of every vertex
+    for (const auto &edge : edges)
+    {
+        ownOffsets[edge.src + 1]++;
+        ownOffsets[edge.dest + 1]++;
+    }
+    // Prefix sums turn the degrees into row offsets
+    for (int u = 0; u < V; ++u)
+        ownOffsets[u + 1] += ownOffsets[u];
+
+    // Scatter both directions of every edge into its rows
+    std::vector<size_t> next(ownOffsets.begin(), ownOffsets.end() - 1);
+    for (const auto &edge : edges)
+    {
+        size_t i = next[edge.src]++;
+        ownNeighbors[i] = edge.dest;
+        ownWeights[i] = edge.weight;
+
+        size_t j = next[edge.dest]++;
+        ownNeighbors[j] = edge.src;
+        ownWeights[j] = edge.weight;
+    }
+    attachOwnArrays();
+}
+
+/**
+ * @brief Wraps CSR arrays that live elsewhere, e.g. in a mapped graph file
+ * (see GraphFile.h), without copying them. 'storage' owns the arrays and is
+ * released together with the last reference to this graph.
+ */
+CSRGraph::CSRGraph(int numVertices, size_t numEntries, uint64_t version, const size_t *offsets, const int *neighbors,
+                   const double *weights, std::shared_ptr<const void> storage)
+    : V(numVertices), version(version), numEntries(numEntries), offsets(offsets), neighbors(neighbors),
+      weights(weights), storage(std::move(storage))
+{
+}
+
+// Points the array views at the vectors the constructor filled
+void CSRGraph::attachOwnArrays()
+{
+    numEntries = ownNeighbors.size();
+    offsets = ownOffsets.data();
+    neighbors = ownNeighbors.data();
+    weights = ownWeights.data();
+}
+
+WeightType CSRGraph::getWeightType() const
+{
+    std::call_once(weightsClassified, &CSRGraph::classifyWeights, this);
+    return weightType;
+}
+
+uint32_t CSRGraph::getMaxIntegerWeight() const
+{
+    getWeightType();
+    return maxIntegerWeight;
+}
+
+/**
+ * @brief Finds the narrowest weight type in one pass and fills in the copy of
+ * the weights in it. Whole numbers take precedence over floats, because they
+ * can be bucketed and radix-sorted directly.
+ */
+void CSRGraph::classifyWeights() const
+{
+    bool integers = true, floats = true;
+    uint32_t largest = 0;
+    for (size_t i = 0; i < numEntries && (integers || floats); ++i)
+    {
+        double w = weights[i];
+        if (integers)
+        {
+            integers = w >= 0.0 && w <= std::numeric_limits<uint32_t>::max() && w == static_cast<uint32_t>(w);
+            if (integers && w > largest)
+                largest = static_cast<uint32_t>(w);
+        }
+        if (floats)
+            floats = static_cast<double>(static_cast<float>(w)) == w;
+    }
+
+    if (integers)
+    {
+        integerWeights.assign(weights, weights + numEntries);
+        maxIntegerWeight = largest;
+        weightType = WeightType::UInt32;
+    }
+    else if (floats)
+    {
+        floatWeights.assign(weights, weights + numEntries);
+        weightType = WeightType::Float;
+    }
+}
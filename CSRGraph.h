@@ -0,0 +1,118 @@
+// CSRGraph.h
+#ifndef CSRGRAPH_H
+#define CSRGRAPH_H
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+#include "Edge.h"
+
+class Graph;
+
+// Narrowest type that holds every weight of a graph exactly (see CSRGraph::getWeightType())
+enum class WeightType
+{
+    UInt32, // Whole numbers from 0 to 2^32 - 1
+    Float,  // Values a float represents exactly
+    Double
+};
+
+/**
+ * @brief Immutable compressed-sparse-row view of an undirected graph.
+ *
+ * The adjacency of vertex v lives in the half-open range [begin(v), end(v))
+ * of the neighbor and weight arrays. Every undirected edge appears twice, once
+ * from each endpoint, exactly like in Graph's adjacency lists. The source
+ * vertex is implied by the row, so each entry costs 12 bytes instead of a
+ * 24-byte Edge and the rows of consecutive vertices are contiguous in memory.
+ *
+ * A CSRGraph is built once per graph version (see Graph::getCSR()) and is
+ * never modified afterwards, so it can be shared between threads freely. The
+ * arrays are either owned by the CSRGraph or viewed in place, e.g. in a
+ * memory-mapped graph file (see GraphFile.h); the accessors are the same.
+ *
+ * Weights are stored as double. Kernels specialized on the weight type ask
+ * getWeightType() once per run: the first call classifies the weights and, if
+ * they all fit a 4-byte type exactly, keeps a copy of them in that type, which
+ * getWeightsAs() returns. Scanning a row then reads 8 bytes per entry instead
+ * of 12, and integer weights can be sorted and queued by value.
+ */
+class CSRGraph
+{
+public:
+    explicit CSRGraph(const Graph &graph);
+    CSRGraph(int numVertices, const std::vector<Edge> &edges);
+    CSRGraph(int numVertices, size_t numEntries, uint64_t version, const size_t *offsets, const int *neighbors,
+             const double *weights, std::shared_ptr<const void> storage);
+    CSRGraph(const CSRGraph &) = delete;
+    CSRGraph &operator=(const CSRGraph &) = delete;
+
+    int getNumVertices() const { return V; }
+    uint64_t getVersion() const { return version; } // Version of the Graph it was built from, 0 if none
+    size_t getNumEdges() const { return numEntries / 2; }
+
+    size_t begin(int vertex) const { return offsets[vertex]; }
+    size_t end(int vertex) const { return offsets[vertex + 1]; }
+    size_t degree(int vertex) const { return offsets[vertex + 1] - offsets[vertex]; }
+    int neighbor(size_t index) const { return neighbors[index]; }
+    double weight(size_t index) const { return weights[index]; }
+
+    // The whole arrays: V + 1 offsets, and 2E neighbors and weights
+    const size_t *getOffsets() const { return offsets; }
+    const int *getNeighbors() const { return neighbors; }
+    const double *getWeights() const { return weights; }
+
+    // Classifies the weights on the first call; thread-safe
+    WeightType getWeightType() const;
+    // Largest weight when the type is UInt32
+    uint32_t getMaxIntegerWeight() const;
+    // The weights as W, which is double or the type getWeightType() returned
+    template <typename W>
+    const W *getWeightsAs() const;
+
+private:
+    void attachOwnArrays();
+
+    int V;
+    uint64_t version;
+    size_t numEntries;                    // 2E: every undirected edge is stored from both endpoints
+    const size_t *offsets;                // V + 1 entries
+    const int *neighbors;                 // 2E entries
+    const double *weights;                // 2E entries, parallel to neighbors
+    std::vector<size_t> ownOffsets;       // The arrays when this graph owns them
+    std::vector<int> ownNeighbors;
+    std::vector<double> ownWeights;
+    std::shared_ptr<const void> storage;  // Keeps viewed arrays alive
+
+    void classifyWeights() const;
+
+    mutable std::once_flag weightsClassified; // Guards the members below, which are set once
+    mutable WeightType weightType = WeightType::Double;
+    mutable uint32_t maxIntegerWeight = 0;
+    mutable std::vector<uint32_t> integerWeights; // 2E entries if the type is UInt32
+    mutable std::vector<float> floatWeights;      // 2E entries if the type is Float
+};
+
+template <>
+inline const double *CSRGraph::getWeightsAs<double>() const
+{
+    return weights;
+}
+
+template <>
+inline const uint32_t *CSRGraph::getWeightsAs<uint32_t>() const
+{
+    getWeightType();
+    return integerWeights.data();
+}
+
+template <>
+inline const float *CSRGraph::getWeightsAs<float>() const
+{
+    getWeightType();
+    return floatWeights.data();
+}
+
+#endif // CSRGRAPH_H
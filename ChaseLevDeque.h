@@ -0,0 +1,126 @@
+// ChaseLevDeque.h
+#ifndef CHASELEVDEQUE_H
+#define CHASELEVDEQUE_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief Lock-free work-stealing deque (Chase and Lev, with the C11 memory
+ * orderings of Le, Pop, Cohen and Zappa Nardelli).
+ *
+ * One owner thread pushes and pops at the bottom (LIFO, good for cache reuse);
+ * any other thread may steal from the top (FIFO). Only the last remaining item
+ * is contended, and then a single CAS on 'top' decides who gets it.
+ *
+ * T must be trivially copyable (the thread pool stores task pointers). When
+ * the ring is full the owner doubles it; the old ring stays alive until the
+ * deque is destroyed because a thief may still be reading from it.
+ */
+template <typename T>
+class ChaseLevDeque
+{
+public:
+    explicit ChaseLevDeque(size_t capacity = 256) : top(0), bottom(0)
+    {
+        rings.emplace_back(new Ring(capacity));
+        ring.store(rings.back().get(), std::memory_order_relaxed);
+    }
+
+    // Owner only
+    void push(T item)
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        Ring *r = ring.load(std::memory_order_relaxed);
+        if (b - t > static_cast<int64_t>(r->capacity) - 1)
+            r = grow(r, t, b);
+        r->put(b, item);
+        // Publishes the item to thieves, which read 'bottom' with acquire
+        bottom.store(b + 1, std::memory_order_release);
+    }
+
+    // Owner only
+    bool pop(T &item)
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Ring *r = ring.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            // Empty
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        item = r->get(b);
+        if (t == b)
+        {
+            // Last item: race the thieves for it
+            bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // Any thread
+    bool steal(T &item)
+    {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b)
+            return false;
+
+        Ring *r = ring.load(std::memory_order_acquire);
+        T candidate = r->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return false; // Lost to the owner or another thief
+        item = candidate;
+        return true;
+    }
+
+    // Any thread; only a hint while other threads are pushing or taking
+    bool empty() const
+    {
+        int64_t b = bottom.load(std::memory_order_acquire);
+        int64_t t = top.load(std::memory_order_acquire);
+        return t >= b;
+    }
+
+private:
+    struct Ring
+    {
+        explicit Ring(size_t capacity) : capacity(capacity), mask(capacity - 1), slots(new std::atomic<T>[capacity]) {}
+
+        T get(int64_t i) const { return slots[i & mask].load(std::memory_order_relaxed); }
+        void put(int64_t i, T item) { slots[i & mask].store(item, std::memory_order_relaxed); }
+
+        size_t capacity; // Always a power of two
+        size_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+    };
+
+    Ring *grow(Ring *old, int64_t t, int64_t b)
+    {
+        rings.emplace_back(new Ring(old->capacity * 2));
+        Ring *bigger = rings.back().get();
+        for (int64_t i = t; i < b; ++i)
+            bigger->put(i, old->get(i));
+        ring.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    std::atomic<int64_t> top;
+    std::atomic<int64_t> bottom;
+    std::atomic<Ring *> ring;
+    std::vector<std::unique_ptr<Ring>> rings; // Current and retired rings, touched by the owner only
+};
+
+#endif // CHASELEVDEQUE_H
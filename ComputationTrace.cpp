@@ -0,0 +1,90 @@
+// ComputationTrace.cpp
+#include "ComputationTrace.h"
+#include <cstdio>
+
+namespace
+{
+    // Event names as they appear in a full trace and in the summary, in TraceEvent order
+    const char *const eventNames[] = {"push", "sorted", "include", "skip", "set-key", "lower-key"};
+}
+
+ComputationTrace::ComputationTrace(TraceLevel level, TraceSink *sink)
+    : level(level), sink(sink), streaming(level == TraceLevel::Full && sink), counts()
+{
+    if (streaming)
+        chunk.reserve(CHUNK_BYTES + 128);
+}
+
+void ComputationTrace::record(TraceEvent kind, int src, int dest, double weight)
+{
+    ++counts[static_cast<int>(kind)];
+    if (!streaming)
+        return;
+
+    char line[96];
+    int length = std::snprintf(line, sizeof(line), "%s %d %d %g\n", eventNames[static_cast<int>(kind)], src, dest,
+                               weight);
+    chunk.append(line, length);
+    if (chunk.size() >= CHUNK_BYTES)
+        flushChunk();
+}
+
+void ComputationTrace::addNote(const std::string &text, bool inSummary)
+{
+    if (inSummary)
+        notes += text + "\n";
+    if (!streaming)
+        return;
+    chunk += "# " + text + "\n";
+    if (chunk.size() >= CHUNK_BYTES)
+        flushChunk();
+}
+
+void ComputationTrace::flushChunk()
+{
+    if (!sink->write(chunk))
+        streaming = false; // The reader is gone; keep counting only
+    chunk.clear();
+}
+
+void ComputationTrace::finish()
+{
+    if (streaming && !chunk.empty())
+        flushChunk();
+}
+
+std::string ComputationTrace::getSummary() const
+{
+    std::string summary = notes;
+    std::string steps;
+    for (int kind = 0; kind < static_cast<int>(TraceEvent::Count); ++kind)
+    {
+        if (counts[kind] == 0)
+            continue;
+        steps += (steps.empty() ? "" : ", ") + std::to_string(counts[kind]) + " " + eventNames[kind];
+    }
+    if (!steps.empty())
+        summary += "Steps: " + steps + ".\n";
+    return summary;
+}
+
+uint64_t ComputationTrace::getEventCount() const
+{
+    uint64_t total = 0;
+    for (uint64_t count : counts)
+        total += count;
+    return total;
+}
+
+const char *traceLevelName(TraceLevel level)
+{
+    switch (level)
+    {
+    case TraceLevel::Summary:
+        return "summary";
+    case TraceLevel::Full:
+        return "full";
+    default:
+        return "off";
+    }
+}
@@ -0,0 +1,117 @@
+// ComputationTrace.h
+#ifndef COMPUTATIONTRACE_H
+#define COMPUTATIONTRACE_H
+
+#include <string>
+#include <sstream>
+#include <cstdint>
+#include "Edge.h"
+
+// How much of its work an MST computation reports, chosen per request
+enum class TraceLevel
+{
+    Off,     // Nothing; the algorithms do no formatting at all
+    Summary, // A few lines: the algorithm's phases and how many steps of each kind it took
+    Full     // Additionally every step as one event line, streamed to a TraceSink
+};
+
+// Kinds of step recorded as events
+enum class TraceEvent
+{
+    Push,     // Edge added to a priority queue
+    Sorted,   // Edge in sorted order
+    Include,  // Edge added to the MST
+    Skip,     // Edge rejected because it would close a cycle
+    SetKey,   // Vertex dest reached for the first time, via the edge
+    LowerKey, // Cheaper edge found to vertex dest
+    Count
+};
+
+// Receives the text of a full trace in chunks
+class TraceSink
+{
+public:
+    virtual ~TraceSink() {}
+    // Returns false once nobody reads the trace any more
+    virtual bool write(const std::string &chunk) = 0;
+};
+
+/**
+ * @brief The steps of one MST computation, at the level the request asked for.
+ *
+ * Algorithms report every step with event() and the start of every phase with
+ * note(); both return right away at TraceLevel::Off, so an untraced run builds
+ * no strings. At Summary the events are only counted. At Full each one is
+ * formatted as a line "<kind> <src> <dest> <weight>" into a chunk that goes
+ * to the sink whenever it is full, so a trace of any length takes one chunk
+ * of memory; notes become lines starting with "# ".
+ *
+ * detail() is for notes that may come up once per small piece of work and are
+ * only wanted in a full trace. A trace is used by one thread at a time.
+ */
+class ComputationTrace
+{
+public:
+    static const size_t CHUNK_BYTES = 64 * 1024;
+
+    explicit ComputationTrace(TraceLevel level = TraceLevel::Off, TraceSink *sink = nullptr);
+    ComputationTrace(const ComputationTrace &) = delete;
+    ComputationTrace &operator=(const ComputationTrace &) = delete;
+
+    TraceLevel getLevel() const { return level; }
+    bool enabled() const { return level != TraceLevel::Off; }
+
+    void event(TraceEvent kind, int src, int dest, double weight)
+    {
+        if (level != TraceLevel::Off)
+            record(kind, src, dest, weight);
+    }
+    void event(TraceEvent kind, const Edge &edge) { event(kind, edge.src, edge.dest, edge.weight); }
+
+    template <typename... Parts>
+    void note(const Parts &...parts)
+    {
+        if (level != TraceLevel::Off)
+            addNote(concatenate(parts...), true);
+    }
+
+    template <typename... Parts>
+    void detail(const Parts &...parts)
+    {
+        if (streaming)
+            addNote(concatenate(parts...), false);
+    }
+
+    // Sends what is left of a full trace to the sink
+    void finish();
+
+    // The notes and the number of events of each kind, for the result block
+    std::string getSummary() const;
+    uint64_t getEventCount() const;
+
+private:
+    template <typename... Parts>
+    static std::string concatenate(const Parts &...parts)
+    {
+        std::ostringstream text;
+        int expand[] = {0, ((void)(text << parts), 0)...};
+        (void)expand;
+        return text.str();
+    }
+
+    void record(TraceEvent kind, int src, int dest, double weight);
+    void addNote(const std::string &text, bool inSummary);
+    void flushChunk();
+
+    TraceLevel level;
+    TraceSink *sink;
+    bool streaming; // Full level and the sink still takes chunks
+    std::string chunk;
+    std::string notes;
+    uint64_t counts[static_cast<int>(TraceEvent::Count)];
+};
+
+// "off", "summary" or "full"
+const char *traceLevelName(TraceLevel level);
+
+#endif // COMPUTATIONTRACE_H
@@ -0,0 +1,77 @@
+// ConcurrentDisjointSet.cpp
+#include "ConcurrentDisjointSet.h"
+
+ConcurrentDisjointSet::ConcurrentDisjointSet(int n) : n(n), parent(new std::atomic<int>[n])
+{
+    for (int i = 0; i < n; ++i)
+        parent[i].store(i, std::memory_order_relaxed);
+}
+
+/**
+ * Returns the current root of the set containing u.
+ *
+ * Path halving: each step tries to point u at its grandparent. A failed CAS
+ * only means another thread changed the parent first, which is harmless
+ * because parents only ever move closer to the root.
+ */
+int ConcurrentDisjointSet::find(int u)
+{
+    while (true)
+    {
+        int p = parent[u].load(std::memory_order_acquire);
+        if (p == u)
+            return u;
+        int gp = parent[p].load(std::memory_order_acquire);
+        if (p != gp)
+            parent[u].compare_exchange_weak(p, gp, std::memory_order_release, std::memory_order_relaxed);
+        u = gp;
+    }
+}
+
+/**
+ * Merges the sets containing u and v.
+ *
+ * The root with the smaller index is linked below the one with the larger
+ * index. If another thread links that root first, the CAS fails and the loop
+ * retries with the new roots.
+ *
+ * Returns false if u and v were already in the same set.
+ */
+bool ConcurrentDisjointSet::unite(int u, int v)
+{
+    while (true)
+    {
+        u = find(u);
+        v = find(v);
+        if (u == v)
+            return false;
+        if (u > v)
+        {
+            int tmp = u;
+            u = v;
+            v = tmp;
+        }
+        int expected = u;
+        if (parent[u].compare_exchange_strong(expected, v, std::memory_order_acq_rel, std::memory_order_relaxed))
+            return true;
+    }
+}
+
+/**
+ * Returns true if u and v are in the same set.
+ *
+ * Two different roots are only a valid answer if the first one is still a
+ * root afterwards; otherwise a concurrent unite moved it and we look again.
+ */
+bool ConcurrentDisjointSet::sameSet(int u, int v)
+{
+    while (true)
+    {
+        u = find(u);
+        v = find(v);
+        if (u == v)
+            return true;
+        if (parent[u].load(std::memory_order_acquire) == u)
+            return false;
+    }
+}
@@ -0,0 +1,30 @@
+// ConcurrentDisjointSet.h
+#ifndef CONCURRENTDISJOINTSET_H
+#define CONCURRENTDISJOINTSET_H
+
+#include <atomic>
+#include <memory>
+
+/**
+ * @brief Lock-free union-find that many threads can use at the same time.
+ *
+ * Parents are std::atomic<int>. find() does path halving with compare-and-swap,
+ * unite() links one root below the other with a CAS that only succeeds while
+ * the linked node is still a root. Roots are always linked from the smaller to
+ * the larger index, which rules out cycles without any lock.
+ */
+class ConcurrentDisjointSet
+{
+public:
+    ConcurrentDisjointSet(int n);
+    int find(int u);
+    bool unite(int u, int v);
+    bool sameSet(int u, int v);
+    int size() const { return n; }
+
+private:
+    int n;
+    std::unique_ptr<std::atomic<int>[]> parent;
+};
+
+#endif // CONCURRENTDISJOINTSET_H
@@ -0,0 +1,216 @@
+// DensePrimAlgorithm.cpp
+#include "DensePrimAlgorithm.h"
+#include "IndexedPrimAlgorithm.h"
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define DENSE_PRIM_X86 1
+#include <immintrin.h>
+#else
+#define DENSE_PRIM_X86 0
+#endif
+
+namespace
+{
+    // Keys are scanned this many at a time at most (4 doubles per AVX register); the key array is padded to it
+    const size_t LANES = 4;
+
+    /**
+     * Returns the vertex with the smallest finite key, or -1 if there is none;
+     * ties go to the lowest vertex. Vertices in the tree and the padding hold
+     * NaN keys, and a comparison with NaN is false, so the scan needs no mask.
+     */
+    typedef int (*MinScanFunction)(const double *key, size_t n);
+
+    int scalarMinScan(const double *key, size_t n)
+    {
+        int picked = -1;
+        double best = std::numeric_limits<double>::infinity();
+        for (size_t v = 0; v < n; ++v)
+        {
+            if (key[v] < best)
+            {
+                best = key[v];
+                picked = static_cast<int>(v);
+            }
+        }
+        return picked;
+    }
+
+#if DENSE_PRIM_X86
+    // Smallest of the per-lane minima, with the same tie-breaking as the scalar scan
+    int reduceLanes(const double *best, const double *bestIndex, size_t lanes)
+    {
+        int picked = -1;
+        double pickedKey = std::numeric_limits<double>::infinity();
+        for (size_t lane = 0; lane < lanes; ++lane)
+        {
+            if (bestIndex[lane] < 0)
+                continue;
+            if (best[lane] < pickedKey || (best[lane] == pickedKey && bestIndex[lane] < picked))
+            {
+                picked = static_cast<int>(bestIndex[lane]);
+                pickedKey = best[lane];
+            }
+        }
+        return picked;
+    }
+
+    // The indices are tracked as doubles so that they blend in the same registers as the keys
+    int sse2MinScan(const double *key, size_t n)
+    {
+        const __m128d two = _mm_set1_pd(2);
+        __m128d index = _mm_set_pd(1, 0);
+        __m128d best = _mm_set1_pd(std::numeric_limits<double>::infinity());
+        __m128d bestIndex = _mm_set1_pd(-1);
+        for (size_t v = 0; v < n; v += 2)
+        {
+            __m128d k = _mm_loadu_pd(key + v);
+            __m128d lower = _mm_cmplt_pd(k, best);
+            best = _mm_or_pd(_mm_and_pd(lower, k), _mm_andnot_pd(lower, best));
+            bestIndex = _mm_or_pd(_mm_and_pd(lower, index), _mm_andnot_pd(lower, bestIndex));
+            index = _mm_add_pd(index, two);
+        }
+        double bests[2], indices[2];
+        _mm_storeu_pd(bests, best);
+        _mm_storeu_pd(indices, bestIndex);
+        return reduceLanes(bests, indices, 2);
+    }
+
+    __attribute__((target("avx2"))) int avx2MinScan(const double *key, size_t n)
+    {
+        const __m256d four = _mm256_set1_pd(4);
+        __m256d index = _mm256_set_pd(3, 2, 1, 0);
+        __m256d best = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+        __m256d bestIndex = _mm256_set1_pd(-1);
+        for (size_t v = 0; v < n; v += 4)
+        {
+            __m256d k = _mm256_loadu_pd(key + v);
+            __m256d lower = _mm256_cmp_pd(k, best, _CMP_LT_OQ);
+            best = _mm256_blendv_pd(best, k, lower);
+            bestIndex = _mm256_blendv_pd(bestIndex, index, lower);
+            index = _mm256_add_pd(index, four);
+        }
+        double bests[4], indices[4];
+        _mm256_storeu_pd(bests, best);
+        _mm256_storeu_pd(indices, bestIndex);
+        return reduceLanes(bests, indices, 4);
+    }
+#endif
+
+    // Widest scan the CPU supports
+    MinScanFunction selectMinScan(const char *&name)
+    {
+#if DENSE_PRIM_X86
+        if (__builtin_cpu_supports("avx2"))
+        {
+            name = "AVX2";
+            return avx2MinScan;
+        }
+        if (__builtin_cpu_supports("sse2"))
+        {
+            name = "SSE2";
+            return sse2MinScan;
+        }
+#endif
+        name = "scalar";
+        return scalarMinScan;
+    }
+
+    // Dense Prim on weights of type W (see DensePrimAlgorithm::computeMST())
+    template <typename W>
+    std::vector<Edge> densePrim(const CSRGraph &graph, const W *weights, MinScanFunction minScan,
+                                ComputationTrace &trace)
+    {
+        int V = graph.getNumVertices();
+        size_t n = (static_cast<size_t>(V) + LANES - 1) / LANES * LANES;
+        std::vector<double> key(n, std::numeric_limits<double>::infinity()); // NaN once in the tree
+        std::vector<int> parent(V, -1);
+        for (size_t v = V; v < n; ++v)
+            key[v] = std::numeric_limits<double>::quiet_NaN();
+
+        std::vector<Edge> mstEdges;
+        mstEdges.reserve(V - 1);
+        trace.note("Include vertex 0 in MST.");
+        key[0] = std::numeric_limits<double>::quiet_NaN();
+        for (int u = 0;;)
+        {
+            // Lower the keys the new tree vertex offers; the key array is small enough to stay in cache
+            for (size_t i = graph.begin(u); i < graph.end(u); ++i)
+            {
+                int v = graph.neighbor(i);
+                double w = weights[i];
+                if (w < key[v])
+                {
+                    trace.event(parent[v] == -1 ? TraceEvent::SetKey : TraceEvent::LowerKey, u, v, w);
+                    key[v] = w;
+                    parent[v] = u;
+                }
+            }
+
+            int next = minScan(key.data(), n);
+            if (next < 0)
+                break;
+            mstEdges.emplace_back(parent[next], next, key[next]);
+            trace.event(TraceEvent::Include, mstEdges.back());
+            key[next] = std::numeric_limits<double>::quiet_NaN();
+            u = next;
+        }
+        return mstEdges;
+    }
+}
+
+bool DensePrimAlgorithm::isDenseEnough(const CSRGraph &graph)
+{
+    double V = graph.getNumVertices();
+    return V >= 2 && graph.getNumEdges() >= MIN_DENSITY * V * (V - 1) / 2;
+}
+
+/**
+ * @brief Computes the Minimum Spanning Tree (MST) of a dense graph using
+ * Prim's algorithm with a key array instead of a heap.
+ *
+ * Every vertex outside the tree keeps the weight of its cheapest edge to the
+ * tree in an array indexed by vertex. Each of the V steps lowers the keys
+ * along the row of the vertex that joined last and then finds the smallest
+ * key with a linear scan, 4 (AVX2) or 2 (SSE2) keys at a time: O(E + V^2)
+ * work in total, with no heap and no edge copies. That beats the heap kernels
+ * once E is a fair fraction of V^2 (see isDenseEnough()); sparser graphs go
+ * to IndexedPrimAlgorithm.
+ *
+ * The CSR rows already hold each vertex's weights contiguously, so the
+ * kernel reads them in place rather than expanding the graph into a V x V
+ * matrix, whose construction alone costs more than the whole run.
+ *
+ * Like PrimAlgorithm it starts from vertex 0 and spans the component of vertex 0.
+ *
+ * @param graph The input graph in compressed-sparse-row form.
+ * @param trace Receives every key that is set or lowered and every included edge.
+ *
+ * @return A vector of edges representing the MST of the input graph.
+ */
+std::vector<Edge> DensePrimAlgorithm::computeMST(const CSRGraph &graph, ComputationTrace &trace)
+{
+    if (!isDenseEnough(graph))
+    {
+        trace.note("The graph is too sparse for dense Prim's algorithm; using Prim's algorithm with an indexed "
+                   "heap instead.");
+        IndexedPrimAlgorithm heapPrim;
+        return heapPrim.computeMST(graph, trace);
+    }
+
+    const char *scanName;
+    MinScanFunction minScan = selectMinScan(scanName);
+    switch (graph.getWeightType())
+    {
+    case WeightType::UInt32:
+        trace.note("Starting dense Prim's algorithm (integer weights, ", scanName, " scan):");
+        return densePrim(graph, graph.getWeightsAs<uint32_t>(), minScan, trace);
+    case WeightType::Float:
+        trace.note("Starting dense Prim's algorithm (float weights, ", scanName, " scan):");
+        return densePrim(graph, graph.getWeightsAs<float>(), minScan, trace);
+    default:
+        trace.note("Starting dense Prim's algorithm (", scanName, " scan):");
+        return densePrim(graph, graph.getWeights(), minScan, trace);
+    }
+}
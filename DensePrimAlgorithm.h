@@ -0,0 +1,19 @@
+// DensePrimAlgorithm.h
+#ifndef DENSEPRIMALGORITHM_H
+#define DENSEPRIMALGORITHM_H
+
+#include "MSTAlgorithm.h"
+
+// O(V^2) Prim's algorithm with a key array and a vectorized minimum scan, for near-complete graphs
+class DensePrimAlgorithm : public MSTAlgorithm {
+public:
+    // Of the V(V-1)/2 possible edges; sparser graphs go to IndexedPrimAlgorithm
+    static constexpr double MIN_DENSITY = 0.25;
+
+    static bool isDenseEnough(const CSRGraph& graph);
+
+    std::vector<Edge> computeMST(const CSRGraph& graph, ComputationTrace& trace) override;
+    std::string getName() const override { return "DensePrim"; }
+};
+
+#endif // DENSEPRIMALGORITHM_H
@@ -1,45 +1,58 @@
 // DisjointSet.cpp
 #include "DisjointSet.h"
 
-DisjointSet::DisjointSet(int n) : parent(n), rank(n, 0) 
+DisjointSet::DisjointSet(int n) : parent(n), size(n, 1) 
 {
     for(int i = 0; i < n; ++i)
         parent[i] = i;
 }
 
+    /**
+     * Returns the root of the set containing u
+     *
+     * This walks up iteratively with path halving: every visited node is pointed at
+     * its grandparent. It flattens the tree about as well as full path compression
+     * but needs no recursion, so deep trees cannot overflow the stack.
+     */
 int DisjointSet::find(int u) 
 {
-    if(parent[u] != u)
-        parent[u] = find(parent[u]);
-    return parent[u];
+    while (parent[u] != u)
+    {
+        parent[u] = parent[parent[u]];
+        u = parent[u];
+    }
+    return u;
 }
 
     /**
      * Merges the sets containing u and v
      * 
-     * This performs the union by rank optimization, which means that the tree with
-     * the smaller rank gets attached to the tree with the larger rank. This heuristic
-     * tends to keep the tree balanced, which keeps the time complexity of the find
+     * This performs the union by size optimization, which means that the tree with
+     * fewer elements gets attached to the root of the larger one. This heuristic
+     * keeps the trees shallow, which keeps the time complexity of the find
      * operation low.
+     *
+     * Returns false if u and v were already in the same set.
      */
-void DisjointSet::unite(int u, int v) 
+bool DisjointSet::unite(int u, int v) 
 {
     // Find the root of the set that contains u
     u = find(u);
     // Find the root of the set that contains v
     v = find(v);
-    
-    // If u and v are in different sets, perform union
-    if (rank[u] < rank[v]) {
-        // Attach the tree with root u to the tree with root v
-        parent[u] = v;
-    } else if (rank[u] > rank[v]) {
-        // Attach the tree with root v to the tree with root u
-        parent[v] = u;
-    } else {
-        // If both trees have the same rank, attach one to the other
-        // and increment the rank of the resulting tree's root
-        parent[v] = u;
-        rank[u]++;
+
+    // Nothing to do if u and v are already in the same set
+    if (u == v)
+        return false;
+
+    // Attach the smaller tree below the root of the larger tree
+    if (size[u] < size[v])
+    {
+        int tmp = u;
+        u = v;
+        v = tmp;
     }
+    parent[v] = u;
+    size[u] += size[v];
+    return true;
 }
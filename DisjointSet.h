@@ -9,10 +9,10 @@ class DisjointSet
 public:
     DisjointSet(int n);
     int find(int u);
-    void unite(int u, int v);
+    bool unite(int u, int v);
 private:
     std::vector<int> parent;
-    std::vector<int> rank;
+    std::vector<int> size; // Number of elements below each root
 };
 
 #endif // DISJOINTSET_H
@@ -0,0 +1,165 @@
+// DynamicMST.cpp
+#include "DynamicMST.h"
+#include <algorithm>
+#include <limits>
+
+/**
+ * @brief Seeds the forest from the current graph version.
+ *
+ * The edges are inserted in ascending weight order, which is Kruskal's
+ * algorithm with the link-cut tree answering the connectivity questions.
+ */
+DynamicMST::DynamicMST(const CSRGraph &graph)
+    : V(graph.getNumVertices()), forest(V, -std::numeric_limits<double>::infinity()), editCount(0)
+{
+    std::vector<Edge> all;
+    all.reserve(graph.getNumEdges());
+    for (int u = 0; u < V; ++u)
+    {
+        size_t selfLoopEntries = 0;
+        for (size_t i = graph.begin(u); i < graph.end(u); ++i)
+        {
+            int v = graph.neighbor(i);
+            // Self loops appear twice in their row; keep one record each
+            if (u < v || (u == v && selfLoopEntries++ % 2 == 0))
+                all.emplace_back(u, v, graph.weight(i));
+        }
+    }
+    std::sort(all.begin(), all.end(), [](const Edge &e1, const Edge &e2)
+              { return e1.weight < e2.weight; });
+
+    for (const auto &edge : all)
+    {
+        int id = newRecord(edge.src, edge.dest, edge.weight);
+        if (edge.src != edge.dest && !forest.connected(edge.src, edge.dest))
+            linkTreeEdge(id);
+    }
+}
+
+uint64_t DynamicMST::pairKey(int u, int v)
+{
+    if (u > v)
+        std::swap(u, v);
+    return (static_cast<uint64_t>(static_cast<uint32_t>(u)) << 32) | static_cast<uint32_t>(v);
+}
+
+int DynamicMST::newRecord(int src, int dest, double weight)
+{
+    EdgeRecord record = {src, dest, weight, false, true, 0};
+    int id;
+    if (!freeIds.empty())
+    {
+        id = freeIds.back();
+        freeIds.pop_back();
+        edges[id] = record;
+        forest.setValue(edgeNode(id), weight);
+    }
+    else
+    {
+        id = static_cast<int>(edges.size());
+        edges.push_back(record);
+        forest.addNode(weight);
+    }
+    byPair[pairKey(src, dest)].push_back(id);
+    return id;
+}
+
+void DynamicMST::linkTreeEdge(int id)
+{
+    forest.link(edges[id].src, edgeNode(id));
+    forest.link(edgeNode(id), edges[id].dest);
+    edges[id].inTree = true;
+    edges[id].treeSlot = treeEdges.size();
+    treeEdges.push_back(id);
+}
+
+void DynamicMST::cutTreeEdge(int id)
+{
+    forest.cut(edges[id].src, edgeNode(id));
+    forest.cut(edgeNode(id), edges[id].dest);
+    edges[id].inTree = false;
+
+    // Swap-remove from the list of tree edges
+    int moved = treeEdges.back();
+    treeEdges[edges[id].treeSlot] = moved;
+    edges[moved].treeSlot = edges[id].treeSlot;
+    treeEdges.pop_back();
+}
+
+void DynamicMST::addEdge(int src, int dest, double weight)
+{
+    ++editCount;
+    int id = newRecord(src, dest, weight);
+    if (src == dest)
+        return;
+
+    if (!forest.connected(src, dest))
+    {
+        linkTreeEdge(id);
+        return;
+    }
+
+    // The new edge closes a cycle; it wins if it is lighter than the heaviest edge on it
+    int heaviest = forest.pathMax(src, dest) - V;
+    if (edges[heaviest].weight > weight)
+    {
+        cutTreeEdge(heaviest);
+        linkTreeEdge(id);
+    }
+}
+
+void DynamicMST::removeEdge(int src, int dest)
+{
+    ++editCount;
+    auto it = byPair.find(pairKey(src, dest));
+    if (it == byPair.end())
+        return;
+
+    // Graph::removeEdge drops every parallel edge between the two vertices
+    bool cutTree = false;
+    for (int id : it->second)
+    {
+        if (edges[id].inTree)
+        {
+            cutTreeEdge(id);
+            cutTree = true;
+        }
+        edges[id].alive = false;
+        freeIds.push_back(id);
+    }
+    byPair.erase(it);
+
+    // Parallel edges are never both in the tree, so at most one cut needs repairing
+    if (cutTree)
+        findReplacement();
+}
+
+/**
+ * Links the lightest live non-tree edge whose endpoints are now in different
+ * trees. After a single cut, that edge reconnects exactly the two halves.
+ */
+void DynamicMST::findReplacement()
+{
+    int best = -1;
+    for (size_t id = 0; id < edges.size(); ++id)
+    {
+        const EdgeRecord &record = edges[id];
+        if (!record.alive || record.inTree || record.src == record.dest)
+            continue;
+        if (best != -1 && record.weight >= edges[best].weight)
+            continue;
+        if (!forest.connected(record.src, record.dest))
+            best = static_cast<int>(id);
+    }
+    if (best != -1)
+        linkTreeEdge(best);
+}
+
+std::vector<Edge> DynamicMST::getMSTEdges() const
+{
+    std::vector<Edge> mstEdges;
+    mstEdges.reserve(treeEdges.size());
+    for (int id : treeEdges)
+        mstEdges.emplace_back(edges[id].src, edges[id].dest, edges[id].weight);
+    return mstEdges;
+}
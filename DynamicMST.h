@@ -0,0 +1,62 @@
+// DynamicMST.h
+#ifndef DYNAMICMST_H
+#define DYNAMICMST_H
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+#include "Edge.h"
+#include "CSRGraph.h"
+#include "LinkCutTree.h"
+
+/**
+ * @brief Minimum spanning forest that is kept up to date across edge edits.
+ *
+ * Mirrors Graph::addEdge / Graph::removeEdge. The forest lives in a link-cut
+ * tree in which every tree edge is a node of its own carrying the edge weight,
+ * so the heaviest edge on a tree path is a single pathMax query.
+ *
+ * - Inserting an edge that joins two trees links it. Otherwise it replaces the
+ *   heaviest edge on the cycle it closes, if it is lighter (O(log V)).
+ * - Deleting a non-tree edge only forgets it. Deleting a tree edge cuts it and
+ *   links the lightest remaining edge that reconnects the two halves, found by
+ *   scanning the non-tree edges (O(E log V)).
+ */
+class DynamicMST
+{
+public:
+    explicit DynamicMST(const CSRGraph &graph);
+    void addEdge(int src, int dest, double weight);
+    void removeEdge(int src, int dest);
+    std::vector<Edge> getMSTEdges() const;
+    size_t getEditCount() const { return editCount; }
+
+private:
+    struct EdgeRecord
+    {
+        int src;
+        int dest;
+        double weight;
+        bool inTree;
+        bool alive;
+        size_t treeSlot; // Position in treeEdges while inTree
+    };
+
+    static uint64_t pairKey(int u, int v);
+    int newRecord(int src, int dest, double weight);
+    void linkTreeEdge(int id);
+    void cutTreeEdge(int id);
+    void findReplacement();
+    int edgeNode(int id) const { return V + id; }
+
+    int V;
+    LinkCutTree forest;                                   // Vertices 0..V-1, then one node per edge record
+    std::vector<EdgeRecord> edges;                        // Indexed by record id
+    std::vector<int> freeIds;                             // Dead record ids ready for reuse
+    std::vector<int> treeEdges;                           // Record ids of the current forest edges
+    std::unordered_map<uint64_t, std::vector<int>> byPair; // Live record ids per unordered vertex pair
+    size_t editCount;
+};
+
+#endif // DYNAMICMST_H
@@ -11,4 +11,18 @@ struct Edge
     Edge(int s, int d, double w) : src(s), dest(d), weight(w) {}
 };
 
+// Edge with a weight of the graph's own type, for kernels specialized on it (see CSRGraph::getWeightType())
+template <typename W>
+struct WeightedEdge
+{
+    int src;
+    int dest;
+    W weight;
+
+    WeightedEdge() = default;
+    WeightedEdge(int s, int d, W w) : src(s), dest(d), weight(w) {}
+
+    Edge toEdge() const { return Edge(src, dest, static_cast<double>(weight)); }
+};
+
 #endif // EDGE_H
@@ -0,0 +1,188 @@
+// FilterKruskalAlgorithm.cpp
+#include "FilterKruskalAlgorithm.h"
+#include "ParallelFor.h"
+#include <algorithm>
+
+namespace
+{
+    // Below this many edges the remaining edges are simply sorted
+    const size_t BASE_CASE_EDGES = 4096;
+
+    /**
+     * Moves the edges of 'in' that satisfy 'pred' to the front of 'out' and the
+     * rest behind them (or drops the rest when keepRejected is false). Each worker
+     * counts its chunk first, so after a prefix sum every worker knows where to
+     * scatter its edges without synchronising with the others.
+     *
+     * @return The number of edges that satisfied the predicate.
+     */
+    template <typename Pred>
+    size_t parallelSplit(const std::vector<Edge> &in, std::vector<Edge> &out, Pred pred, bool keepRejected)
+    {
+        size_t n = in.size();
+        size_t workers = parallelWorkerCount();
+        size_t chunk = (n + workers - 1) / workers;
+        std::vector<size_t> accepted(workers, 0), rejected(workers, 0);
+
+        parallelFor(0, workers, [&](size_t begin, size_t end, unsigned)
+                    {
+            for (size_t w = begin; w < end; ++w)
+                for (size_t i = w * chunk; i < std::min(n, (w + 1) * chunk); ++i)
+                    (pred(in[i]) ? accepted[w] : rejected[w])++; }, 1);
+
+        size_t totalAccepted = 0, totalRejected = 0;
+        std::vector<size_t> acceptedAt(workers), rejectedAt(workers);
+        for (size_t w = 0; w < workers; ++w)
+        {
+            acceptedAt[w] = totalAccepted;
+            totalAccepted += accepted[w];
+        }
+        for (size_t w = 0; w < workers; ++w)
+        {
+            rejectedAt[w] = totalAccepted + totalRejected;
+            totalRejected += rejected[w];
+        }
+
+        out.resize(keepRejected ? n : totalAccepted, Edge(0, 0, 0.0));
+        parallelFor(0, workers, [&](size_t begin, size_t end, unsigned)
+                    {
+            for (size_t w = begin; w < end; ++w)
+            {
+                size_t a = acceptedAt[w], r = rejectedAt[w];
+                for (size_t i = w * chunk; i < std::min(n, (w + 1) * chunk); ++i)
+                {
+                    if (pred(in[i]))
+                        out[a++] = in[i];
+                    else if (keepRejected)
+                        out[r++] = in[i];
+                }
+            } }, 1);
+
+        return totalAccepted;
+    }
+
+    // Median of nine evenly spaced samples, a cheap and robust pivot for the weights
+    double choosePivot(const std::vector<Edge> &edges)
+    {
+        double samples[9];
+        for (size_t s = 0; s < 9; ++s)
+            samples[s] = edges[s * (edges.size() - 1) / 8].weight;
+        std::nth_element(samples, samples + 4, samples + 9);
+        return samples[4];
+    }
+}
+
+/**
+ * @brief Computes the Minimum Spanning Tree (MST) of a graph using Filter-Kruskal.
+ *
+ * Plain Kruskal sorts all E edges although it usually stops after the first
+ * V - 1 accepted ones. Filter-Kruskal avoids most of that sort:
+ *
+ * 1. The edges are partitioned around a pivot weight into a light and a heavy part.
+ * 2. The light part is processed first (recursively).
+ * 3. Heavy edges whose endpoints are already in one component are filtered out,
+ *    because they can never enter the MST, and only the survivors are processed.
+ *
+ * Small parts fall back to sort-and-scan Kruskal. Partitioning and filtering run
+ * in parallel across cores; the filtering workers share one lock-free
+ * ConcurrentDisjointSet, whose finds compress paths safely in parallel.
+ *
+ * @param graph The input graph in compressed-sparse-row form.
+ * @param trace Receives the included and skipped edges; partitions and filters
+ * only appear in a full trace.
+ *
+ * @return A vector of edges representing the MST of the input graph.
+ */
+std::vector<Edge> FilterKruskalAlgorithm::computeMST(const CSRGraph &graph, ComputationTrace &trace)
+{
+    size_t V = graph.getNumVertices();
+    std::vector<Edge> edges;
+    std::vector<Edge> scratch;
+    std::vector<Edge> mstEdges;
+    ConcurrentDisjointSet ds(V);
+
+    trace.note("Starting Filter-Kruskal algorithm:");
+
+    // Collect all edges from the CSR rows
+    edges.reserve(graph.getNumEdges());
+    for (size_t u = 0; u < V; ++u)
+    {
+        for (size_t i = graph.begin(u); i < graph.end(u); ++i)
+        {
+            if (u < static_cast<size_t>(graph.neighbor(i))) // Avoid duplicates in undirected graph
+                edges.emplace_back(u, graph.neighbor(i), graph.weight(i));
+        }
+    }
+
+    if (V > 1)
+        filterKruskal(edges, scratch, ds, mstEdges, V - 1, trace);
+
+    return mstEdges;
+}
+
+void FilterKruskalAlgorithm::filterKruskal(std::vector<Edge> &edges, std::vector<Edge> &scratch, ConcurrentDisjointSet &ds,
+                                           std::vector<Edge> &mstEdges, size_t target, ComputationTrace &trace)
+{
+    if (edges.empty() || mstEdges.size() == target)
+        return;
+    if (edges.size() <= BASE_CASE_EDGES)
+    {
+        kruskalBase(edges, ds, mstEdges, target, trace);
+        return;
+    }
+
+    double pivot = choosePivot(edges);
+    size_t lightCount = parallelSplit(edges, scratch, [pivot](const Edge &e)
+                                      { return e.weight <= pivot; }, true);
+    if (lightCount == edges.size())
+    {
+        // All remaining edges weigh at most the pivot; partitioning cannot make progress
+        kruskalBase(edges, ds, mstEdges, target, trace);
+        return;
+    }
+    trace.detail("Partitioned ", edges.size(), " edges around weight ", pivot, ": ", lightCount, " light, ",
+                 edges.size() - lightCount, " heavy.");
+
+    std::vector<Edge> light(scratch.begin(), scratch.begin() + lightCount);
+    std::vector<Edge> heavy(scratch.begin() + lightCount, scratch.end());
+    edges.clear();
+    edges.shrink_to_fit();
+
+    // Light edges first
+    filterKruskal(light, scratch, ds, mstEdges, target, trace);
+    if (mstEdges.size() == target)
+        return;
+
+    // Drop heavy edges that would close a cycle, then process the survivors
+    size_t heavyCount = heavy.size();
+    parallelSplit(heavy, scratch, [&ds](const Edge &e)
+                  { return !ds.sameSet(e.src, e.dest); }, false);
+    heavy.swap(scratch);
+    trace.detail("Filtered out ", heavyCount - heavy.size(), " heavy edges inside one component.");
+
+    filterKruskal(heavy, scratch, ds, mstEdges, target, trace);
+}
+
+void FilterKruskalAlgorithm::kruskalBase(std::vector<Edge> &edges, ConcurrentDisjointSet &ds,
+                                         std::vector<Edge> &mstEdges, size_t target, ComputationTrace &trace)
+{
+    std::sort(edges.begin(), edges.end(),
+              [](const Edge &e1, const Edge &e2)
+              { return e1.weight < e2.weight; });
+
+    for (auto &edge : edges)
+    {
+        if (ds.unite(edge.src, edge.dest))
+        {
+            mstEdges.push_back(edge);
+            trace.event(TraceEvent::Include, edge);
+        }
+        else
+        {
+            trace.event(TraceEvent::Skip, edge);
+        }
+
+        if (mstEdges.size() == target)
+            break;
+    }
+}
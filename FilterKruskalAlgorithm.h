@@ -0,0 +1,20 @@
+// FilterKruskalAlgorithm.h
+#ifndef FILTERKRUSKALALGORITHM_H
+#define FILTERKRUSKALALGORITHM_H
+
+#include "MSTAlgorithm.h"
+#include "ConcurrentDisjointSet.h"
+
+// Kruskal's algorithm that partitions around pivots and filters heavy edges instead of fully sorting
+class FilterKruskalAlgorithm : public MSTAlgorithm {
+public:
+    std::vector<Edge> computeMST(const CSRGraph& graph, ComputationTrace& trace) override;
+    std::string getName() const override { return "FilterKruskal"; }
+private:
+    void filterKruskal(std::vector<Edge>& edges, std::vector<Edge>& scratch, ConcurrentDisjointSet& ds,
+                       std::vector<Edge>& mstEdges, size_t target, ComputationTrace& trace);
+    void kruskalBase(std::vector<Edge>& edges, ConcurrentDisjointSet& ds,
+                     std::vector<Edge>& mstEdges, size_t target, ComputationTrace& trace);
+};
+
+#endif // FILTERKRUSKALALGORITHM_H
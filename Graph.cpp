@@ -1,8 +1,37 @@
 // Graph.cpp
 #include "Graph.h"
 #include <algorithm>
+#include <atomic>
 
-Graph::Graph(int vertices) : V(vertices), adjList(vertices) {}
+// Source of graph versions for all Graph objects, so a version number identifies
+// one state of one graph even after the graph is deleted and another is created
+static uint64_t nextGraphVersion()
+{
+    static std::atomic<uint64_t> counter(0);
+    return ++counter;
+}
+
+uint64_t Graph::newVersion()
+{
+    return nextGraphVersion();
+}
+
+Graph::Graph(int vertices) : V(vertices), E(0), version(nextGraphVersion()), adjList(vertices) {}
+
+/**
+ * @brief Copies a CSR graph into adjacency lists, e.g. to edit a graph that
+ * was opened read-only from a file. The lists keep the order of the rows.
+ */
+Graph::Graph(const CSRGraph &csr)
+    : V(csr.getNumVertices()), E(csr.getNumEdges()), version(nextGraphVersion()), adjList(V)
+{
+    for (int u = 0; u < V; ++u)
+    {
+        adjList[u].reserve(csr.degree(u));
+        for (size_t i = csr.begin(u); i < csr.end(u); ++i)
+            adjList[u].emplace_back(u, csr.neighbor(i), csr.weight(i));
+    }
+}
 
 void Graph::addEdge(int src, int dest, double weight)
 {
@@ -10,10 +39,43 @@ void Graph::addEdge(int src, int dest, double weight)
     Edge edge2(dest, src, weight);
     adjList[src].push_back(edge1);
     adjList[dest].push_back(edge2);
+    E++;
+    version = nextGraphVersion();
+    csrCache.reset();
+}
+
+/**
+ * @brief Adds many edges at once, e.g. from a bulk upload.
+ *
+ * Equivalent to calling addEdge() for every record, but counts the new degree
+ * of every vertex first so each adjacency list grows with a single allocation,
+ * and changes the version only once. Endpoints must be valid vertices.
+ */
+void Graph::addEdges(const std::vector<BulkEdge> &edges)
+{
+    std::vector<size_t> added(V, 0);
+    for (const auto &edge : edges)
+    {
+        added[edge.src]++;
+        added[edge.dest]++;
+    }
+    for (int u = 0; u < V; ++u)
+        adjList[u].reserve(adjList[u].size() + added[u]);
+
+    for (const auto &edge : edges)
+    {
+        adjList[edge.src].emplace_back(edge.src, edge.dest, edge.weight);
+        adjList[edge.dest].emplace_back(edge.dest, edge.src, edge.weight);
+    }
+    E += edges.size();
+    version = nextGraphVersion();
+    csrCache.reset();
 }
 
 void Graph::removeEdge(int src, int dest)
 {
+    // Every edge has two entries: one per endpoint, or both in the list of a self-loop
+    size_t before = adjList[src].size() + (src != dest ? adjList[dest].size() : 0);
     adjList[src].erase(std::remove_if(adjList[src].begin(), adjList[src].end(),
                                       [dest](Edge &e)
                                       { return e.dest == dest; }),
@@ -23,6 +85,14 @@ void Graph::removeEdge(int src, int dest)
                                        [src](Edge &e)
                                        { return e.dest == src; }),
                         adjList[dest].end());
+    E -= (before - adjList[src].size() - (src != dest ? adjList[dest].size() : 0)) / 2;
+    version = nextGraphVersion();
+    csrCache.reset();
+}
+
+uint64_t Graph::getVersion() const
+{
+    return version;
 }
 
 int Graph::getNumVertices() const
@@ -30,7 +100,28 @@ int Graph::getNumVertices() const
     return V;
 }
 
+size_t Graph::getNumEdges() const
+{
+    return E;
+}
+
 const std::vector<Edge> &Graph::getAdjEdges(int vertex) const
 {
     return adjList[vertex];
 }
+
+/**
+ * @brief Returns the CSR snapshot of the current graph version.
+ *
+ * The snapshot is built on the first call after an edit and shared by every
+ * later call until the next addEdge/removeEdge. Callers must hold the same lock
+ * that protects the edits (or own a graph no other thread can see yet); the
+ * returned snapshot itself is immutable and stays valid after the lock is
+ * released.
+ */
+std::shared_ptr<const CSRGraph> Graph::getCSR() const
+{
+    if (!csrCache)
+        csrCache = std::make_shared<const CSRGraph>(*this);
+    return csrCache;
+}
@@ -3,20 +3,34 @@
 #define GRAPH_H
 
 #include <vector>
+#include <memory>
+#include <cstdint>
 #include "Edge.h"
+#include "CSRGraph.h"
+#include "BulkProtocol.h"
 
 class Graph
 {
 public:
     Graph(int vertices);
+    explicit Graph(const CSRGraph &csr);
     void addEdge(int src, int dest, double weight);
+    void addEdges(const std::vector<BulkEdge> &edges);
     void removeEdge(int src, int dest);
     int getNumVertices() const;
+    size_t getNumEdges() const;
     const std::vector<Edge> &getAdjEdges(int vertex) const;
+    std::shared_ptr<const CSRGraph> getCSR() const;
+    uint64_t getVersion() const;
+
+    static uint64_t newVersion(); // A version number no graph state has had yet
 
 private:
     int V;
+    size_t E;
+    uint64_t version; // Changes on every edit; never shared between two graphs or two states
     std::vector<std::vector<Edge>> adjList;
+    mutable std::shared_ptr<const CSRGraph> csrCache; // Reset by every edit, rebuilt on demand
 };
 
 #endif // GRAPH_H
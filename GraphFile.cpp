@@ -0,0 +1,147 @@
+// GraphFile.cpp
+#include "GraphFile.h"
+#include "Graph.h"
+#include <fstream>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Rounds a file position up to the next section boundary
+static uint64_t alignSection(uint64_t position)
+{
+    return (position + GRAPH_FILE_ALIGNMENT - 1) / GRAPH_FILE_ALIGNMENT * GRAPH_FILE_ALIGNMENT;
+}
+
+// Writes one section and the zero padding up to 'end'
+static void writeSection(std::ofstream &file, const void *data, uint64_t size, uint64_t start, uint64_t end)
+{
+    static const char zeros[GRAPH_FILE_ALIGNMENT] = {};
+    file.seekp(start);
+    file.write(static_cast<const char *>(data), size);
+    file.write(zeros, end - start - size);
+}
+
+bool saveGraphFile(const CSRGraph &graph, const std::string &path, std::string &error)
+{
+    GraphFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, GRAPH_FILE_MAGIC, sizeof(GRAPH_FILE_MAGIC));
+    header.byteOrder = GRAPH_FILE_BYTE_ORDER;
+    header.numVertices = graph.getNumVertices();
+    header.numEntries = 2 * graph.getNumEdges();
+    header.offsetsStart = sizeof(GraphFileHeader);
+    header.neighborsStart = alignSection(header.offsetsStart + (header.numVertices + 1) * sizeof(uint64_t));
+    header.weightsStart = alignSection(header.neighborsStart + header.numEntries * sizeof(int32_t));
+    header.fileSize = header.weightsStart + header.numEntries * sizeof(double);
+
+    std::string temporary = path + ".tmp";
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        error = "Cannot create " + temporary + ": " + std::strerror(errno);
+        return false;
+    }
+    writeSection(file, &header, sizeof(header), 0, header.offsetsStart);
+    writeSection(file, graph.getOffsets(), (header.numVertices + 1) * sizeof(uint64_t), header.offsetsStart,
+                 header.neighborsStart);
+    writeSection(file, graph.getNeighbors(), header.numEntries * sizeof(int32_t), header.neighborsStart,
+                 header.weightsStart);
+    writeSection(file, graph.getWeights(), header.numEntries * sizeof(double), header.weightsStart, header.fileSize);
+    file.close();
+
+    if (!file || std::rename(temporary.c_str(), path.c_str()) != 0)
+    {
+        error = "Cannot write " + path + ": " + std::strerror(errno);
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Checks that the sections lie inside the file, in order, without overlapping
+static bool validLayout(const GraphFileHeader &header, uint64_t fileSize)
+{
+    if (std::memcmp(header.magic, GRAPH_FILE_MAGIC, sizeof(GRAPH_FILE_MAGIC)) != 0 ||
+        header.byteOrder != GRAPH_FILE_BYTE_ORDER || header.numVertices < 0 || header.fileSize != fileSize)
+        return false;
+    // Bounding the counts by the file size first keeps the products below from overflowing
+    if (static_cast<uint64_t>(header.numVertices) >= fileSize || header.numEntries >= fileSize)
+        return false;
+    if (header.offsetsStart % GRAPH_FILE_ALIGNMENT || header.neighborsStart % GRAPH_FILE_ALIGNMENT ||
+        header.weightsStart % GRAPH_FILE_ALIGNMENT)
+        return false;
+    return header.offsetsStart >= sizeof(GraphFileHeader) &&
+           header.offsetsStart + (header.numVertices + 1) * sizeof(uint64_t) <= header.neighborsStart &&
+           header.neighborsStart + header.numEntries * sizeof(int32_t) <= header.weightsStart &&
+           header.weightsStart + header.numEntries * sizeof(double) <= fileSize;
+}
+
+std::shared_ptr<const CSRGraph> openGraphFile(const std::string &path, const GraphMapHints &hints,
+                                              std::string &error)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        error = "Cannot open " + path + ": " + std::strerror(errno);
+        return nullptr;
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0 || static_cast<uint64_t>(status.st_size) < sizeof(GraphFileHeader))
+    {
+        close(fd);
+        error = path + " is not a graph file.";
+        return nullptr;
+    }
+    size_t size = status.st_size;
+    void *base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // The mapping keeps the file open
+    if (base == MAP_FAILED)
+    {
+        error = "Cannot map " + path + ": " + std::strerror(errno);
+        return nullptr;
+    }
+    // Unmapped when the last CSRGraph viewing it is gone, or right away if the file is rejected
+    std::shared_ptr<const void> mapping(base, [size](const void *address)
+                                       { munmap(const_cast<void *>(address), size); });
+
+    const char *bytes = static_cast<const char *>(base);
+    const GraphFileHeader &header = *reinterpret_cast<const GraphFileHeader *>(bytes);
+    if (!validLayout(header, size))
+    {
+        error = path + " is not a valid graph file.";
+        return nullptr;
+    }
+
+    if (hints.hugePages)
+        madvise(base, size, MADV_HUGEPAGE); // Only a hint; kernels without file huge pages refuse it
+    if (hints.willNeed)
+        madvise(base, size, MADV_WILLNEED);
+
+    // The rows must be in order and cover exactly the neighbor array, every edge stored twice, and every
+    // neighbor must be a vertex: the kernels index their per-vertex arrays with it unchecked
+    const size_t *offsets = reinterpret_cast<const size_t *>(bytes + header.offsetsStart);
+    const int32_t *neighbors = reinterpret_cast<const int32_t *>(bytes + header.neighborsStart);
+    bool validOffsets = offsets[0] == 0 && offsets[header.numVertices] == header.numEntries &&
+                        header.numEntries % 2 == 0;
+    for (int32_t u = 0; validOffsets && u < header.numVertices; ++u)
+    {
+        validOffsets = offsets[u] <= offsets[u + 1];
+        for (size_t i = offsets[u]; validOffsets && i < offsets[u + 1]; ++i)
+            validOffsets = neighbors[i] >= 0 && neighbors[i] < header.numVertices;
+    }
+    if (!validOffsets)
+    {
+        error = path + " has corrupt rows.";
+        return nullptr;
+    }
+
+    return std::make_shared<const CSRGraph>(header.numVertices, header.numEntries, Graph::newVersion(), offsets,
+                                            reinterpret_cast<const int *>(neighbors),
+                                            reinterpret_cast<const double *>(bytes + header.weightsStart),
+                                            std::move(mapping));
+}
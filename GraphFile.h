@@ -0,0 +1,75 @@
+// GraphFile.h
+#ifndef GRAPHFILE_H
+#define GRAPHFILE_H
+
+#include <string>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include "CSRGraph.h"
+
+/**
+ * On-disk graph format: the CSR arrays of a graph exactly as CSRGraph uses
+ * them, so a file can be memory-mapped and used in place without parsing or
+ * copying anything.
+ *
+ *   GraphFileHeader   64 bytes
+ *   offsets           numVertices + 1 uint64, at header.offsetsStart
+ *   neighbors         numEntries int32, at header.neighborsStart
+ *   weights           numEntries float64, at header.weightsStart
+ *
+ * Every section starts at a multiple of GRAPH_FILE_ALIGNMENT bytes, so each
+ * array starts on a cache line. Numbers are stored in the byte order of the
+ * machine that wrote the file; the header records it.
+ */
+static const char GRAPH_FILE_MAGIC[8] = {'M', 'S', 'T', 'C', 'S', 'R', '0', '1'};
+static const uint32_t GRAPH_FILE_BYTE_ORDER = 0x01020304; // Reads differently on a machine of the other byte order
+static const size_t GRAPH_FILE_ALIGNMENT = 64;
+
+struct GraphFileHeader
+{
+    char magic[8];       // GRAPH_FILE_MAGIC
+    uint32_t byteOrder;  // GRAPH_FILE_BYTE_ORDER
+    int32_t numVertices;
+    uint64_t numEntries; // Twice the number of edges: every edge is stored from both endpoints
+    uint64_t offsetsStart;
+    uint64_t neighborsStart;
+    uint64_t weightsStart;
+    uint64_t fileSize;
+    uint64_t reserved;
+};
+
+static_assert(sizeof(GraphFileHeader) == GRAPH_FILE_ALIGNMENT, "the header is one aligned section");
+static_assert(sizeof(size_t) == sizeof(uint64_t), "offsets are mapped as size_t");
+
+// Hints given to the kernel for a mapped graph file
+struct GraphMapHints
+{
+    bool willNeed = true;   // MADV_WILLNEED: start reading the whole file in right away
+    bool hugePages = false; // MADV_HUGEPAGE: back the mapping with huge pages where the kernel supports it
+};
+
+/**
+ * @brief Writes a graph to 'path' in the format above.
+ *
+ * The file is written next to 'path' under a temporary name and renamed into
+ * place, so a file that is mapped by a running server is never overwritten
+ * while in use.
+ * @return false with a message in 'error' if the file cannot be written.
+ */
+bool saveGraphFile(const CSRGraph &graph, const std::string &path, std::string &error);
+
+/**
+ * @brief Maps a graph file read-only and returns a CSRGraph that views it.
+ *
+ * The arrays are used in place, without parsing or copying. Opening makes one
+ * pass over the offsets and the neighbor indices to validate them, since the
+ * file may come from anywhere; the weights are not read until used (or read
+ * ahead, see GraphMapHints). The mapping lives as long as the returned graph,
+ * which gets a new version number.
+ * @return null with a message in 'error' if the file is missing or malformed.
+ */
+std::shared_ptr<const CSRGraph> openGraphFile(const std::string &path, const GraphMapHints &hints,
+                                              std::string &error);
+
+#endif // GRAPHFILE_H
@@ -0,0 +1,164 @@
+// GraphStore.cpp
+#include "GraphStore.h"
+#include <functional>
+#include <algorithm>
+
+GraphEntry::GraphEntry(const std::string &name)
+    : name(name), graph(nullptr), maintainedMST(nullptr), memoryEstimate(0), lastUsed(0)
+{
+    pthread_mutex_init(&mutex, nullptr);
+}
+
+GraphEntry::~GraphEntry()
+{
+    delete maintainedMST;
+    delete graph;
+    pthread_mutex_destroy(&mutex);
+}
+
+// Adjacency lists plus the CSR snapshot built from them, including the 4-byte copy of the weights
+// that kernels specialized on the weight type may add to it; the maintained MST is not counted,
+// nor are mapped files, whose pages belong to the kernel's page cache
+static size_t estimateMemory(const Graph &graph)
+{
+    size_t vertices = graph.getNumVertices();
+    size_t entries = 2 * graph.getNumEdges(); // Every edge is stored once from each endpoint
+    return vertices * (sizeof(std::vector<Edge>) + sizeof(size_t)) +
+           entries * (sizeof(Edge) + sizeof(int) + sizeof(double) + sizeof(uint32_t));
+}
+
+GraphStore::GraphStore(size_t shardCount) : clock(0), memoryUsage(0)
+{
+    for (size_t i = 0; i < shardCount; ++i)
+        shards.emplace_back(new Shard());
+}
+
+GraphStore::Shard &GraphStore::shardOf(const std::string &name)
+{
+    return *shards[std::hash<std::string>()(name) % shards.size()];
+}
+
+std::shared_ptr<GraphEntry> GraphStore::find(const std::string &name)
+{
+    Shard &shard = shardOf(name);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.graphs.find(name);
+    if (it == shard.graphs.end())
+        return nullptr;
+    it->second->lastUsed.store(++clock);
+    return it->second;
+}
+
+std::shared_ptr<GraphEntry> GraphStore::findOrCreate(const std::string &name)
+{
+    Shard &shard = shardOf(name);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    std::shared_ptr<GraphEntry> &entry = shard.graphs[name];
+    if (!entry)
+        entry = std::make_shared<GraphEntry>(name);
+    entry->lastUsed.store(++clock);
+    return entry;
+}
+
+void GraphStore::updateMemory(GraphEntry &entry)
+{
+    size_t estimate = entry.graph ? estimateMemory(*entry.graph) : 0;
+    memoryUsage += estimate;
+    memoryUsage -= entry.memoryEstimate;
+    entry.memoryEstimate = estimate;
+}
+
+/**
+ * @brief Evicts idle graphs until the memory estimate fits the budget.
+ *
+ * A graph is idle when the store holds the only reference to it: no client
+ * request and no computation is using it. Since references are only handed
+ * out under the shard lock, a graph that is idle while the lock is held stays
+ * idle until it is erased. Each round picks the least recently used idle graph
+ * of all shards; graphs in use are never evicted, so the estimate may stay
+ * above the budget for a while.
+ */
+std::vector<std::string> GraphStore::evictIdle(size_t budget)
+{
+    std::vector<std::string> evicted;
+    if (memoryUsage.load() <= budget)
+        return evicted;
+
+    std::lock_guard<std::mutex> evictionLock(evictionMutex);
+    while (memoryUsage.load() > budget)
+    {
+        // Find the least recently used idle graph
+        Shard *oldestShard = nullptr;
+        std::string oldestName;
+        uint64_t oldestUse = UINT64_MAX;
+        for (auto &shard : shards)
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            for (const auto &item : shard->graphs)
+            {
+                uint64_t used = item.second->lastUsed.load();
+                if (item.second.use_count() == 1 && used < oldestUse)
+                {
+                    oldestShard = shard.get();
+                    oldestName = item.first;
+                    oldestUse = used;
+                }
+            }
+        }
+        if (!oldestShard)
+            break; // Every graph is in use
+
+        std::shared_ptr<GraphEntry> entry;
+        {
+            std::lock_guard<std::mutex> lock(oldestShard->mutex);
+            auto it = oldestShard->graphs.find(oldestName);
+            if (it == oldestShard->graphs.end() || it->second.use_count() != 1 ||
+                it->second->lastUsed.load() != oldestUse)
+                continue; // Used again since the scan; look for another one
+            entry = std::move(it->second);
+            oldestShard->graphs.erase(it);
+        }
+        pthread_mutex_lock(&entry->mutex);
+        memoryUsage -= entry->memoryEstimate;
+        pthread_mutex_unlock(&entry->mutex);
+        evicted.push_back(oldestName);
+    }
+    return evicted;
+}
+
+std::vector<GraphSummary> GraphStore::list()
+{
+    std::vector<std::shared_ptr<GraphEntry>> entries;
+    for (auto &shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        for (const auto &item : shard->graphs)
+            entries.push_back(item.second);
+    }
+
+    std::vector<GraphSummary> summaries;
+    for (const auto &entry : entries)
+    {
+        GraphSummary summary;
+        summary.name = entry->name;
+        pthread_mutex_lock(&entry->mutex);
+        if (entry->graph)
+        {
+            summary.vertices = entry->graph->getNumVertices();
+            summary.edges = entry->graph->getNumEdges();
+        }
+        else if (entry->mapped)
+        {
+            summary.vertices = entry->mapped->getNumVertices();
+            summary.edges = entry->mapped->getNumEdges();
+            summary.mapped = true;
+        }
+        summary.memoryEstimate = entry->memoryEstimate;
+        pthread_mutex_unlock(&entry->mutex);
+        summaries.push_back(summary);
+    }
+    std::sort(summaries.begin(), summaries.end(),
+              [](const GraphSummary &a, const GraphSummary &b)
+              { return a.name < b.name; });
+    return summaries;
+}
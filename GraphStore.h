@@ -0,0 +1,102 @@
+// GraphStore.h
+#ifndef GRAPHSTORE_H
+#define GRAPHSTORE_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <pthread.h>
+#include "Graph.h"
+#include "DynamicMST.h"
+#include "VersionedGraph.h"
+
+/**
+ * @brief One named graph of the store and everything that belongs to it.
+ *
+ * 'mutex' serializes the writers of this graph only, so edits of different
+ * graphs never wait for each other. Computations read the snapshots published
+ * in 'versions' without taking it.
+ *
+ * A graph opened from a file has no Graph: it is the read-only CSRGraph in
+ * 'mapped', viewing the memory-mapped file, until the first edit copies it
+ * into a Graph.
+ */
+struct GraphEntry
+{
+    explicit GraphEntry(const std::string &name);
+    ~GraphEntry();
+    GraphEntry(const GraphEntry &) = delete;
+    GraphEntry &operator=(const GraphEntry &) = delete;
+
+    const std::string name;
+    pthread_mutex_t mutex;
+    Graph *graph;                           // Null until the graph is created; protected by mutex
+    std::shared_ptr<const CSRGraph> mapped; // Set instead of graph while it is a mapped file; protected by mutex
+    VersionedGraph versions;                // Told about every change of the graph's version, under mutex
+    DynamicMST *maintainedMST;              // MST of the graph kept up to date across edits; protected by mutex
+    size_t memoryEstimate;                  // Bytes counted against the store's budget; protected by mutex
+    std::atomic<uint64_t> lastUsed;         // Store clock at the last lookup, for eviction
+};
+
+// What the graph list shows about one graph
+struct GraphSummary
+{
+    std::string name;
+    int vertices = 0;
+    size_t edges = 0;
+    size_t memoryEstimate = 0;
+    bool mapped = false; // Read-only view of a graph file
+};
+
+/**
+ * @brief Concurrent map from graph names to graphs, for many independent
+ * clients in one server.
+ *
+ * The names are spread over shards with a lock each, so lookups of different
+ * graphs rarely contend; a lookup only holds its shard lock to find the entry
+ * and returns a shared_ptr, so a graph that is in use stays alive. The store
+ * keeps an estimate of the memory all graphs take, and evictIdle() drops the
+ * least recently used graphs that nobody holds until the estimate fits the
+ * budget again.
+ */
+class GraphStore
+{
+public:
+    explicit GraphStore(size_t shardCount = 16);
+
+    // The named graph, or null if there is none
+    std::shared_ptr<GraphEntry> find(const std::string &name);
+    // The named graph, added with no Graph in it if there is none
+    std::shared_ptr<GraphEntry> findOrCreate(const std::string &name);
+
+    // Called with entry.mutex held, after its graph was created, replaced or edited
+    void updateMemory(GraphEntry &entry);
+
+    // Drops idle graphs, least recently used first, until the estimate is at
+    // most 'budget' bytes; returns the names of the dropped graphs
+    std::vector<std::string> evictIdle(size_t budget);
+
+    std::vector<GraphSummary> list();
+    size_t getMemoryUsage() const { return memoryUsage.load(); }
+
+private:
+    struct Shard
+    {
+        std::mutex mutex;
+        std::unordered_map<std::string, std::shared_ptr<GraphEntry>> graphs;
+    };
+
+    Shard &shardOf(const std::string &name);
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<uint64_t> clock;       // Advanced by every lookup
+    std::atomic<size_t> memoryUsage;   // Sum of the memoryEstimate of all graphs in the store
+    std::mutex evictionMutex;          // One eviction pass at a time
+};
+
+#endif // GRAPHSTORE_H
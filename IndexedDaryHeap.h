@@ -0,0 +1,112 @@
+// IndexedDaryHeap.h
+#ifndef INDEXEDDARYHEAP_H
+#define INDEXEDDARYHEAP_H
+
+#include <vector>
+#include <cstddef>
+
+/**
+ * @brief Min-heap over the item ids 0..n-1 with decrease-key, stored as a d-ary tree.
+ *
+ * Every item is in the heap at most once, so the heap never holds more than n
+ * entries. A position table maps each item to its slot so decreaseKey can sift
+ * it up in place. With D = 4 the children of a slot share one cache line and
+ * the tree is half as deep as a binary heap.
+ */
+template <typename Key, unsigned D = 4>
+class IndexedDaryHeap
+{
+public:
+    explicit IndexedDaryHeap(int n) : position(n, NOT_IN_HEAP), keys(n) { heap.reserve(n); }
+
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    bool contains(int item) const { return position[item] != NOT_IN_HEAP; }
+    const Key &key(int item) const { return keys[item]; }
+
+    // Inserts an item that is not in the heap yet
+    void push(int item, const Key &key)
+    {
+        keys[item] = key;
+        position[item] = heap.size();
+        heap.push_back(item);
+        siftUp(heap.size() - 1);
+    }
+
+    // Lowers the key of an item that is already in the heap
+    void decreaseKey(int item, const Key &key)
+    {
+        keys[item] = key;
+        siftUp(position[item]);
+    }
+
+    // Removes and returns the item with the smallest key
+    int pop()
+    {
+        int top = heap[0];
+        position[top] = NOT_IN_HEAP;
+        int last = heap.back();
+        heap.pop_back();
+        if (!heap.empty())
+        {
+            heap[0] = last;
+            position[last] = 0;
+            siftDown(0);
+        }
+        return top;
+    }
+
+private:
+    static const size_t NOT_IN_HEAP = static_cast<size_t>(-1);
+
+    void siftUp(size_t slot)
+    {
+        int item = heap[slot];
+        while (slot > 0)
+        {
+            size_t parent = (slot - 1) / D;
+            if (!(keys[item] < keys[heap[parent]]))
+                break;
+            heap[slot] = heap[parent];
+            position[heap[slot]] = slot;
+            slot = parent;
+        }
+        heap[slot] = item;
+        position[item] = slot;
+    }
+
+    void siftDown(size_t slot)
+    {
+        int item = heap[slot];
+        size_t n = heap.size();
+        while (true)
+        {
+            size_t first = slot * D + 1;
+            if (first >= n)
+                break;
+            size_t last = first + D < n ? first + D : n;
+            size_t best = first;
+            for (size_t child = first + 1; child < last; ++child)
+            {
+                if (keys[heap[child]] < keys[heap[best]])
+                    best = child;
+            }
+            if (!(keys[heap[best]] < keys[item]))
+                break;
+            heap[slot] = heap[best];
+            position[heap[slot]] = slot;
+            slot = best;
+        }
+        heap[slot] = item;
+        position[item] = slot;
+    }
+
+    std::vector<int> heap;        // Item ids in heap order
+    std::vector<size_t> position; // Slot of every item, NOT_IN_HEAP if absent
+    std::vector<Key> keys;        // Current key of every item
+};
+
+template <typename Key, unsigned D>
+const size_t IndexedDaryHeap<Key, D>::NOT_IN_HEAP;
+
+#endif // INDEXEDDARYHEAP_H
@@ -0,0 +1,75 @@
+// IndexedPrimAlgorithm.cpp
+#include "IndexedPrimAlgorithm.h"
+#include "IndexedDaryHeap.h"
+
+/**
+ * @brief Computes the Minimum Spanning Tree (MST) of a graph using Prim's algorithm
+ * with an indexed 4-ary heap.
+ *
+ * Unlike PrimAlgorithm, which pushes a copy of every scanned edge into a
+ * priority queue and discards stale entries when they are popped, this version
+ * keys the heap by vertex. Each vertex outside the MST is in the heap at most
+ * once with the weight of its cheapest known connecting edge; finding a cheaper
+ * edge lowers that key in place. The heap therefore holds at most V entries and
+ * every pop adds a vertex to the tree.
+ *
+ * Like PrimAlgorithm it starts from vertex 0 and spans the component of vertex 0.
+ *
+ * @param graph The input graph in compressed-sparse-row form.
+ * @param trace Receives every key that is set or lowered and every included edge.
+ *
+ * @return A vector of edges representing the MST of the input graph.
+ */
+std::vector<Edge> IndexedPrimAlgorithm::computeMST(const CSRGraph &graph, ComputationTrace &trace)
+{
+    int V = graph.getNumVertices();
+    std::vector<Edge> mstEdges;
+    if (V == 0)
+        return mstEdges;
+
+    std::vector<bool> inMST(V, false);
+    std::vector<int> parent(V, -1); // Tree endpoint of each vertex's current key
+    IndexedDaryHeap<double, 4> heap(V);
+
+    trace.note("Starting Prim's algorithm (indexed 4-ary heap):");
+
+    heap.push(0, 0.0);
+    while (!heap.empty())
+    {
+        // The vertex with the cheapest connecting edge joins the tree
+        int u = heap.pop();
+        inMST[u] = true;
+        if (parent[u] != -1)
+        {
+            mstEdges.emplace_back(parent[u], u, heap.key(u));
+            trace.event(TraceEvent::Include, mstEdges.back());
+        }
+        else
+        {
+            trace.note("Include vertex ", u, " in MST.");
+        }
+
+        // Relax the edges to vertices still outside the tree
+        for (size_t i = graph.begin(u); i < graph.end(u); ++i)
+        {
+            int v = graph.neighbor(i);
+            double w = graph.weight(i);
+            if (inMST[v])
+                continue;
+            if (!heap.contains(v))
+            {
+                parent[v] = u;
+                heap.push(v, w);
+                trace.event(TraceEvent::SetKey, u, v, w);
+            }
+            else if (w < heap.key(v))
+            {
+                parent[v] = u;
+                heap.decreaseKey(v, w);
+                trace.event(TraceEvent::LowerKey, u, v, w);
+            }
+        }
+    }
+
+    return mstEdges;
+}
@@ -0,0 +1,14 @@
+// IndexedPrimAlgorithm.h
+#ifndef INDEXEDPRIMALGORITHM_H
+#define INDEXEDPRIMALGORITHM_H
+
+#include "MSTAlgorithm.h"
+
+// Prim's algorithm on an indexed 4-ary heap with decrease-key (at most V heap entries)
+class IndexedPrimAlgorithm : public MSTAlgorithm {
+public:
+    std::vector<Edge> computeMST(const CSRGraph& graph, ComputationTrace& trace) override;
+    std::string getName() const override { return "PrimHeap"; }
+};
+
+#endif // INDEXEDPRIMALGORITHM_H
@@ -1,84 +1,115 @@
 // KruskalAlgorithm.cpp
 #include "KruskalAlgorithm.h"
+#include "RadixSort.h"
 #include <algorithm>
-#include <sstream>
 
-/**
- * @brief Computes the Minimum Spanning Tree (MST) of a graph using Kruskal's algorithm.
- *
- * This function implements Kruskal's algorithm to find the MST of the given graph.
- * It first collects all edges in the graph and sorts them by weight.
- * Then it repeatedly selects the edge with the minimum weight that does not form
- * a cycle in the MST, until the MST spans all vertices.
- *
- * The function also maintains a log of the computation steps, which can be retrieved
- * using getComputationLog().
- * 
- * we use disjoint set data structure.
- * its suits well for this algorithm because its head is always the lowest node in the tree.
- *
- * @param graph The input graph represented as an adjacency list.
- *
- * @return A vector of edges representing the MST of the input graph.
- */
-std::vector<Edge> KruskalAlgorithm::computeMST(Graph &graph)
+namespace
 {
-    size_t V = graph.getNumVertices();
-    std::vector<Edge> allEdges;
-    std::vector<Edge> mstEdges;
-    DisjointSet ds(V);
-
-    std::stringstream log;
-    log << "Starting Kruskal's algorithm:\n";
-
-    // Collect all edges from the adjacency list
-    for (size_t u = 0; u < V; ++u)
+    // 4-byte weights (whole numbers or floats) are radix-sorted in linear time
+    template <typename W>
+    void sortByWeight(std::vector<WeightedEdge<W>> &edges)
     {
-        for (auto &edge : graph.getAdjEdges(u))
-        {
-            if (edge.src < edge.dest) // Avoid duplicates in undirected graph
-                allEdges.push_back(edge);
-        }
+        std::vector<WeightedEdge<W>> scratch;
+        radixSort(edges, scratch, [](const WeightedEdge<W> &edge)
+                  { return radixKey(edge.weight); });
     }
 
-    // Sort all edges by weight
-    std::sort(allEdges.begin(), allEdges.end(),
-              [](Edge &e1, Edge &e2)
-              { return e1.weight < e2.weight; });
-    log << "Edges sorted by weight:\n";
-    for (const auto &edge : allEdges)
+    void sortByWeight(std::vector<WeightedEdge<double>> &edges)
     {
-        log << "(" << edge.src << ", " << edge.dest << ") - Weight: " << edge.weight << "\n";
+        std::sort(edges.begin(), edges.end(),
+                  [](const WeightedEdge<double> &e1, const WeightedEdge<double> &e2)
+                  { return e1.weight < e2.weight; });
     }
 
-    // Kruskal's algorithm
-    for (auto &edge : allEdges)
+    // Kruskal's algorithm on weights of type W (see KruskalAlgorithm::computeMST())
+    template <typename W>
+    std::vector<Edge> kruskal(const CSRGraph &graph, const W *weights, ComputationTrace &trace)
     {
-        int uSet = ds.find(edge.src);
-        int vSet = ds.find(edge.dest);
+        size_t V = graph.getNumVertices();
+        std::vector<WeightedEdge<W>> allEdges;
+        std::vector<Edge> mstEdges;
+        DisjointSet ds(V);
 
-        if (uSet != vSet)
+        // Collect all edges from the CSR rows
+        allEdges.reserve(graph.getNumEdges());
+        for (size_t u = 0; u < V; ++u)
         {
-            mstEdges.push_back(edge);
-            ds.unite(uSet, vSet);
-            log << "Include edge (" << edge.src << ", " << edge.dest << ") with weight " << edge.weight << " in MST.\n";
+            for (size_t i = graph.begin(u); i < graph.end(u); ++i)
+            {
+                if (u < static_cast<size_t>(graph.neighbor(i))) // Avoid duplicates in undirected graph
+                    allEdges.emplace_back(u, graph.neighbor(i), weights[i]);
+            }
         }
-        else
+
+        // Sort all edges by weight
+        sortByWeight(allEdges);
+        trace.note("Edges sorted by weight.");
+        if (trace.enabled())
         {
-            log << "Skipping edge (" << edge.src << ", " << edge.dest << ") to avoid cycle.\n";
+            for (const auto &edge : allEdges)
+                trace.event(TraceEvent::Sorted, edge.src, edge.dest, edge.weight);
         }
 
-        if (mstEdges.size() == V - 1)
-            break;
-    }
+        // Kruskal's algorithm
+        for (auto &edge : allEdges)
+        {
+            int uSet = ds.find(edge.src);
+            int vSet = ds.find(edge.dest);
 
-    // Store the log for later retrieval
-    computationLog = log.str();
+            if (uSet != vSet)
+            {
+                mstEdges.push_back(edge.toEdge());
+                ds.unite(uSet, vSet);
+                trace.event(TraceEvent::Include, edge.src, edge.dest, edge.weight);
+            }
+            else
+            {
+                trace.event(TraceEvent::Skip, edge.src, edge.dest, edge.weight);
+            }
 
-    return mstEdges;
+            if (mstEdges.size() == V - 1)
+                break;
+        }
+
+        return mstEdges;
+    }
 }
 
-std::string KruskalAlgorithm::getComputationLog() const
+/**
+ * @brief Computes the Minimum Spanning Tree (MST) of a graph using Kruskal's algorithm.
+ *
+ * This function implements Kruskal's algorithm to find the MST of the given graph.
+ * It first collects all edges in the graph and sorts them by weight.
+ * Then it repeatedly selects the edge with the minimum weight that does not form
+ * a cycle in the MST, until the MST spans all vertices.
+ *
+ * The kernel is chosen once, by the graph's weight type. Weights that fit 4
+ * bytes are collected as 12-byte edges and radix-sorted in linear time; other
+ * weights are sorted by comparison.
+ *
+ * The steps (the sorted edges, then every included or skipped edge) are reported
+ * to the trace.
+ * 
+ * we use disjoint set data structure.
+ * its suits well for this algorithm because its head is always the lowest node in the tree.
+ *
+ * @param graph The input graph in compressed-sparse-row form.
+ * @param trace Receives the computation steps.
+ *
+ * @return A vector of edges representing the MST of the input graph.
+ */
+std::vector<Edge> KruskalAlgorithm::computeMST(const CSRGraph &graph, ComputationTrace &trace)
 {
-    return computationLog;
+    switch (graph.getWeightType())
+    {
+    case WeightType::UInt32:
+        trace.note("Starting Kruskal's algorithm (integer weights, radix sort):");
+        return kruskal(graph, graph.getWeightsAs<uint32_t>(), trace);
+    case WeightType::Float:
+        trace.note("Starting Kruskal's algorithm (float weights, radix sort):");
+        return kruskal(graph, graph.getWeightsAs<float>(), trace);
+    default:
+        trace.note("Starting Kruskal's algorithm:");
+        return kruskal(graph, graph.getWeights(), trace);
+    }
 }
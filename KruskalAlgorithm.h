@@ -7,10 +7,8 @@
 
 class KruskalAlgorithm : public MSTAlgorithm {
 public:
-    std::vector<Edge> computeMST(Graph& graph) override;
-    std::string getComputationLog() const override;  // Implemented method
-private:
-    std::string computationLog;  // Stores computation steps
+    std::vector<Edge> computeMST(const CSRGraph& graph, ComputationTrace& trace) override;
+    std::string getName() const override { return "Kruskal"; }
 };
 
 #endif // KRUSKALALGORITHM_H
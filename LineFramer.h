@@ -0,0 +1,69 @@
+// LineFramer.h
+#ifndef LINEFRAMER_H
+#define LINEFRAMER_H
+
+#include <string>
+#include <cstddef>
+
+/**
+ * @brief Splits a TCP byte stream into newline-terminated lines.
+ *
+ * Bytes are appended as they arrive, however the sender's writes were split or
+ * merged into packets; nextLine() then returns the complete lines one by one,
+ * without their "\n" or "\r\n". A line that is still incomplete stays buffered
+ * until the rest arrives. Consumed lines are only dropped from the buffer when
+ * it runs out of complete lines, so taking many lines out of one large read
+ * costs time linear in its size.
+ */
+class LineFramer
+{
+public:
+    explicit LineFramer(size_t maxLineLength) : maxLineLength(maxLineLength), consumed(0) {}
+
+    void append(const char *data, size_t size) { buffer.append(data, size); }
+
+    bool nextLine(std::string &line)
+    {
+        size_t newline = buffer.find('\n', consumed);
+        if (newline == std::string::npos)
+        {
+            buffer.erase(0, consumed);
+            consumed = 0;
+            return false;
+        }
+
+        size_t lineEnd = newline;
+        if (lineEnd > consumed && buffer[lineEnd - 1] == '\r')
+            --lineEnd;
+        line.assign(buffer, consumed, lineEnd - consumed);
+        consumed = newline + 1;
+        return true;
+    }
+
+    // Unconsumed input, for callers that take binary data out of the stream
+    const char *pending() const { return buffer.data() + consumed; }
+    size_t pendingSize() const { return buffer.size() - consumed; }
+
+    void consume(size_t size)
+    {
+        consumed += size;
+        if (consumed == buffer.size())
+            clear();
+    }
+
+    // True once the unterminated rest of the input is longer than any valid line
+    bool overflowed() const { return pendingSize() > maxLineLength; }
+
+    void clear()
+    {
+        buffer.clear();
+        consumed = 0;
+    }
+
+private:
+    size_t maxLineLength;
+    std::string buffer;
+    size_t consumed; // Bytes at the front of buffer already returned as lines
+};
+
+#endif // LINEFRAMER_H
@@ -0,0 +1,175 @@
+// LinkCutTree.cpp
+#include "LinkCutTree.h"
+#include <utility>
+
+LinkCutTree::LinkCutTree(int n, double value)
+{
+    nodes.reserve(n);
+    for (int i = 0; i < n; ++i)
+        addNode(value);
+}
+
+int LinkCutTree::addNode(double value)
+{
+    Node node;
+    node.child[0] = node.child[1] = -1;
+    node.parent = -1;
+    node.reversed = false;
+    node.value = value;
+    node.best = static_cast<int>(nodes.size());
+    nodes.push_back(node);
+    return node.best;
+}
+
+// Only valid for a node that is isolated or the root of its splay tree after access
+void LinkCutTree::setValue(int x, double value)
+{
+    access(x);
+    nodes[x].value = value;
+    pull(x);
+}
+
+bool LinkCutTree::isSplayRoot(int x) const
+{
+    int p = nodes[x].parent;
+    return p == -1 || (nodes[p].child[0] != x && nodes[p].child[1] != x);
+}
+
+// Recomputes the subtree maximum of x from its children
+void LinkCutTree::pull(int x)
+{
+    Node &node = nodes[x];
+    node.best = x;
+    for (int c : node.child)
+    {
+        if (c != -1 && nodes[nodes[c].best].value > nodes[node.best].value)
+            node.best = nodes[c].best;
+    }
+}
+
+// Pushes a pending reversal of x down to its children
+void LinkCutTree::push(int x)
+{
+    Node &node = nodes[x];
+    if (!node.reversed)
+        return;
+    std::swap(node.child[0], node.child[1]);
+    for (int c : node.child)
+    {
+        if (c != -1)
+            nodes[c].reversed = !nodes[c].reversed;
+    }
+    node.reversed = false;
+}
+
+void LinkCutTree::rotate(int x)
+{
+    int p = nodes[x].parent;
+    int g = nodes[p].parent;
+    int side = nodes[p].child[1] == x ? 1 : 0;
+    int moved = nodes[x].child[side ^ 1];
+
+    // x takes p's place below g (as a real child or as a path-parent pointer)
+    if (!isSplayRoot(p))
+        nodes[g].child[nodes[g].child[1] == p ? 1 : 0] = x;
+    nodes[x].parent = g;
+
+    nodes[p].child[side] = moved;
+    if (moved != -1)
+        nodes[moved].parent = p;
+
+    nodes[x].child[side ^ 1] = p;
+    nodes[p].parent = x;
+
+    pull(p);
+    pull(x);
+}
+
+void LinkCutTree::splay(int x)
+{
+    // Apply pending reversals from the splay root down to x before rotating
+    pathStack.clear();
+    int y = x;
+    pathStack.push_back(y);
+    while (!isSplayRoot(y))
+    {
+        y = nodes[y].parent;
+        pathStack.push_back(y);
+    }
+    for (auto it = pathStack.rbegin(); it != pathStack.rend(); ++it)
+        push(*it);
+
+    while (!isSplayRoot(x))
+    {
+        int p = nodes[x].parent;
+        if (!isSplayRoot(p))
+        {
+            int g = nodes[p].parent;
+            bool zigzig = (nodes[g].child[1] == p) == (nodes[p].child[1] == x);
+            rotate(zigzig ? p : x);
+        }
+        rotate(x);
+    }
+}
+
+// Makes the path from the tree root to x preferred and splays x to the top
+void LinkCutTree::access(int x)
+{
+    int last = -1;
+    for (int y = x; y != -1; y = nodes[y].parent)
+    {
+        splay(y);
+        nodes[y].child[1] = last;
+        pull(y);
+        last = y;
+    }
+    splay(x);
+}
+
+void LinkCutTree::makeRoot(int x)
+{
+    access(x);
+    nodes[x].reversed = !nodes[x].reversed;
+}
+
+int LinkCutTree::findRoot(int x)
+{
+    access(x);
+    while (true)
+    {
+        push(x);
+        if (nodes[x].child[0] == -1)
+            break;
+        x = nodes[x].child[0];
+    }
+    splay(x);
+    return x;
+}
+
+bool LinkCutTree::connected(int u, int v)
+{
+    return u == v || findRoot(u) == findRoot(v);
+}
+
+void LinkCutTree::link(int u, int v)
+{
+    makeRoot(u);
+    nodes[u].parent = v;
+}
+
+void LinkCutTree::cut(int u, int v)
+{
+    makeRoot(u);
+    access(v);
+    // The path is now exactly u - v, with u as the left child of v
+    nodes[v].child[0] = -1;
+    nodes[u].parent = -1;
+    pull(v);
+}
+
+int LinkCutTree::pathMax(int u, int v)
+{
+    makeRoot(u);
+    access(v);
+    return nodes[v].best;
+}
@@ -0,0 +1,52 @@
+// LinkCutTree.h
+#ifndef LINKCUTTREE_H
+#define LINKCUTTREE_H
+
+#include <vector>
+
+/**
+ * @brief Link-cut tree over a dynamic forest with path-maximum queries.
+ *
+ * Every node carries a value; pathMax(u, v) returns the node with the largest
+ * value on the tree path between u and v. All operations take amortized
+ * O(log n) time. Nodes are splay trees over preferred paths, with a lazy
+ * reversal flag so that any node can be made the root of its tree.
+ */
+class LinkCutTree
+{
+public:
+    LinkCutTree(int n, double value);
+    int addNode(double value);
+    void setValue(int x, double value);
+    double getValue(int x) const { return nodes[x].value; }
+    int size() const { return static_cast<int>(nodes.size()); }
+
+    bool connected(int u, int v);
+    void link(int u, int v);  // u and v must be in different trees
+    void cut(int u, int v);   // u and v must be adjacent
+    int pathMax(int u, int v); // u and v must be connected
+
+private:
+    struct Node
+    {
+        int child[2];
+        int parent;
+        bool reversed;
+        double value;
+        int best; // Node with the largest value in this splay subtree
+    };
+
+    bool isSplayRoot(int x) const;
+    void pull(int x);
+    void push(int x);
+    void rotate(int x);
+    void splay(int x);
+    void access(int x);
+    void makeRoot(int x);
+    int findRoot(int x);
+
+    std::vector<Node> nodes;
+    std::vector<int> pathStack; // Reused by splay to push reversal flags top-down
+};
+
+#endif // LINKCUTTREE_H
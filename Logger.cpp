@@ -0,0 +1,147 @@
+// Logger.cpp
+#include "Logger.h"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <cstdio>
+
+Logger &Logger::instance()
+{
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger() : minimumLevel(LogLevel::Info), stopping(false)
+{
+    flusher = std::thread(&Logger::flushLoop, this);
+}
+
+// Writes whatever is still buffered, e.g. when main() returns
+Logger::~Logger()
+{
+    {
+        std::lock_guard<std::mutex> lock(flushMutex);
+        stopping = true;
+    }
+    flushCondition.notify_one();
+    flusher.join();
+}
+
+bool Logger::parseLevel(const std::string &name, LogLevel &level)
+{
+    static const char *const names[] = {"debug", "info", "warning", "error", "off"};
+    for (int i = 0; i < 5; ++i)
+    {
+        if (name == names[i])
+        {
+            level = static_cast<LogLevel>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+Logger::BufferHolder::BufferHolder(Logger &logger) : buffer(std::make_shared<Buffer>())
+{
+    std::lock_guard<std::mutex> lock(logger.buffersMutex);
+    logger.buffers.push_back(buffer);
+}
+
+Logger::BufferHolder::~BufferHolder()
+{
+    buffer->retired.store(true, std::memory_order_release);
+}
+
+Logger::Buffer &Logger::threadBuffer()
+{
+    thread_local BufferHolder holder(*this);
+    return *holder.buffer;
+}
+
+void Logger::write(LogLevel level, std::string message)
+{
+    Record record;
+    record.time = std::chrono::duration_cast<std::chrono::microseconds>(
+                      std::chrono::system_clock::now().time_since_epoch())
+                      .count();
+    record.level = level;
+    record.message = std::move(message);
+
+    Buffer &buffer = threadBuffer();
+    if (!buffer.records.tryPush(record))
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Logger::flushLoop()
+{
+    std::unique_lock<std::mutex> lock(flushMutex);
+    while (!stopping)
+    {
+        flushCondition.wait_for(lock, std::chrono::milliseconds(20));
+        lock.unlock();
+        drain();
+        lock.lock();
+    }
+    lock.unlock();
+    drain();
+}
+
+// Flusher thread only: takes every buffered record and writes them in time order
+void Logger::drain()
+{
+    std::vector<std::shared_ptr<Buffer>> current;
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        current = buffers;
+    }
+
+    std::vector<Record> records;
+    Record record;
+    uint64_t dropped = 0;
+    for (const auto &buffer : current)
+    {
+        while (buffer->records.tryPop(record))
+            records.push_back(std::move(record));
+        dropped += buffer->dropped.exchange(0, std::memory_order_relaxed);
+    }
+
+    {
+        // Buffers of exited threads go once they are empty
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        buffers.erase(std::remove_if(buffers.begin(), buffers.end(),
+                                     [](const std::shared_ptr<Buffer> &buffer)
+                                     { return buffer->retired.load(std::memory_order_acquire) &&
+                                              buffer->records.empty(); }),
+                      buffers.end());
+    }
+
+    if (records.empty() && dropped == 0)
+        return;
+
+    std::stable_sort(records.begin(), records.end(),
+                     [](const Record &a, const Record &b)
+                     { return a.time < b.time; });
+
+    static const char *const levelNames[] = {"DEBUG", "INFO", "WARNING", "ERROR"};
+    std::string output;
+    for (const Record &entry : records)
+    {
+        std::time_t seconds = entry.time / 1000000;
+        std::tm local;
+        localtime_r(&seconds, &local);
+        char prefix[48];
+        std::snprintf(prefix, sizeof(prefix), "[%02d:%02d:%02d.%03d] [%s] ", local.tm_hour, local.tm_min,
+                      local.tm_sec, static_cast<int>(entry.time % 1000000 / 1000),
+                      levelNames[static_cast<int>(entry.level)]);
+        output += prefix;
+        output += entry.message;
+        if (output.empty() || output.back() != '\n')
+            output += '\n';
+    }
+    if (dropped)
+        output += "[WARNING] " + std::to_string(dropped) + " log messages dropped (buffer full).\n";
+
+    std::cout.write(output.data(), output.size());
+    std::cout.flush();
+}
@@ -0,0 +1,120 @@
+// Logger.h
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <string>
+#include <sstream>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+#include "MPSCQueue.h"
+
+enum class LogLevel
+{
+    Debug,
+    Info,
+    Warning,
+    Error,
+    Off
+};
+
+// LOG_DEBUG calls are only compiled into the binary when this is 1 (see the Makefile)
+#ifndef LOG_WITH_DEBUG
+#define LOG_WITH_DEBUG 0
+#endif
+
+/**
+ * @brief Asynchronous leveled logger.
+ *
+ * A log call formats its message on the calling thread and moves it into that
+ * thread's own buffer, a bounded lock-free queue that only this thread
+ * writes, so threads never wait for each other or for the output stream. A
+ * background thread drains all buffers every few milliseconds and writes the
+ * messages, ordered by time, to std::cout in one go. If a buffer is full the
+ * message is dropped and counted rather than blocking the caller.
+ *
+ * Calls below the level chosen at startup cost one relaxed atomic load, and
+ * LOG_DEBUG calls are not compiled at all unless LOG_WITH_DEBUG is set.
+ */
+class Logger
+{
+public:
+    static Logger &instance();
+
+    void setLevel(LogLevel level) { minimumLevel.store(level, std::memory_order_relaxed); }
+    bool enabled(LogLevel level) const { return level >= minimumLevel.load(std::memory_order_relaxed); }
+    void write(LogLevel level, std::string message);
+
+    // "debug", "info", "warning", "error" or "off"; false for anything else
+    static bool parseLevel(const std::string &name, LogLevel &level);
+
+private:
+    struct Record
+    {
+        int64_t time = 0; // Microseconds since the epoch
+        LogLevel level = LogLevel::Info;
+        std::string message;
+    };
+
+    // One thread's messages; it is retired when the thread exits and dropped once drained
+    struct Buffer
+    {
+        Buffer() : records(BUFFER_CAPACITY), dropped(0), retired(false) {}
+        MPSCQueue<Record> records; // Used with a single producer, the owning thread
+        std::atomic<uint64_t> dropped;
+        std::atomic<bool> retired;
+    };
+
+    // Registers the calling thread's buffer on its first log call and retires it at thread exit
+    struct BufferHolder
+    {
+        explicit BufferHolder(Logger &logger);
+        ~BufferHolder();
+        std::shared_ptr<Buffer> buffer;
+    };
+
+    static const size_t BUFFER_CAPACITY = 1024;
+
+    Logger();
+    ~Logger();
+    Buffer &threadBuffer();
+    void flushLoop();
+    void drain();
+
+    std::atomic<LogLevel> minimumLevel;
+    std::mutex buffersMutex; // Guards the list, not the buffers
+    std::vector<std::shared_ptr<Buffer>> buffers;
+    std::mutex flushMutex;
+    std::condition_variable flushCondition;
+    bool stopping;
+    std::thread flusher;
+};
+
+#define LOG_AT(level, expression)                                 \
+    do                                                            \
+    {                                                             \
+        if (Logger::instance().enabled(level))                    \
+        {                                                         \
+            std::ostringstream logStream;                         \
+            logStream << expression;                              \
+            Logger::instance().write(level, logStream.str());     \
+        }                                                         \
+    } while (0)
+
+#if LOG_WITH_DEBUG
+#define LOG_DEBUG(expression) LOG_AT(LogLevel::Debug, expression)
+#else
+#define LOG_DEBUG(expression) \
+    do                        \
+    {                         \
+    } while (0)
+#endif
+#define LOG_INFO(expression) LOG_AT(LogLevel::Info, expression)
+#define LOG_WARNING(expression) LOG_AT(LogLevel::Warning, expression)
+#define LOG_ERROR(expression) LOG_AT(LogLevel::Error, expression)
+
+#endif // LOGGER_H
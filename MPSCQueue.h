@@ -0,0 +1,102 @@
+// MPSCQueue.h
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+/**
+ * @brief Bounded lock-free multi-producer single-consumer ring buffer
+ * (after Dmitry Vyukov's bounded MPMC queue).
+ *
+ * Every slot carries a sequence number that tells producers and the consumer
+ * whose turn it is: a producer claims a position with one CAS on 'tail', moves
+ * its item into the slot and publishes it by advancing the slot's sequence;
+ * the consumer, being the only one, keeps 'head' as a plain variable and hands
+ * the slot back the same way. Items are moved in and out, never copied, and no
+ * operation allocates.
+ *
+ * T must be default-constructible and move-assignable.
+ */
+template <typename T>
+class MPSCQueue
+{
+public:
+    // 'capacity' is rounded up to a power of two
+    explicit MPSCQueue(size_t capacity) : head(0), tail(0)
+    {
+        size_t size = 2;
+        while (size < capacity)
+            size *= 2;
+        mask = size - 1;
+        slots.reset(new Slot[size]);
+        for (size_t i = 0; i < size; ++i)
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    // Any thread; false if the queue is full (the item is left untouched)
+    bool tryPush(T &item)
+    {
+        size_t position = tail.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot &slot = slots[position & mask];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0)
+            {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    slot.value = std::move(item);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false; // The consumer has not freed this slot yet
+            }
+            else
+            {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer thread only; false if the queue is empty
+    bool tryPop(T &item)
+    {
+        Slot &slot = slots[head & mask];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != head + 1)
+            return false; // Empty, or the producer of this slot is still writing it
+        item = std::move(slot.value);
+        slot.sequence.store(head + mask + 1, std::memory_order_release);
+        ++head;
+        return true;
+    }
+
+    // Consumer thread only; also false while a claimed slot is still being written
+    bool empty() const
+    {
+        return tail.load(std::memory_order_acquire) == head;
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+    size_t head;              // Consumer only
+    char padding[64];         // Keeps head and tail on different cache lines
+    std::atomic<size_t> tail; // Shared by the producers
+};
+
+#endif // MPSCQUEUE_H
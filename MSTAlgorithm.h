@@ -5,13 +5,16 @@
 #include <vector>
 #include <string>
 #include "Edge.h"
-#include "Graph.h"
+#include "CSRGraph.h"
+#include "ComputationTrace.h"
 
 class MSTAlgorithm
 {
 public:
-    virtual std::vector<Edge> computeMST(Graph &graph) = 0;
-    virtual std::string getComputationLog() const = 0; // Added method
+    // Reports its steps to 'trace' at whatever level the trace was created with
+    virtual std::vector<Edge> computeMST(const CSRGraph &graph, ComputationTrace &trace) = 0;
+    // Name of the kernel that computes (or, after computeMST(), computed) the tree, as MSTFactory knows it
+    virtual std::string getName() const = 0;
     virtual ~MSTAlgorithm() {}
 };
 
@@ -2,6 +2,13 @@
 #include "MSTFactory.h"
 #include "PrimAlgorithm.h"
 #include "KruskalAlgorithm.h"
+#include "BoruvkaAlgorithm.h"
+#include "IndexedPrimAlgorithm.h"
+#include "FilterKruskalAlgorithm.h"
+#include "DensePrimAlgorithm.h"
+#include "AutoAlgorithm.h"
+
+AlgorithmSelector MSTFactory::selector;
 
 MSTAlgorithm *MSTFactory::createAlgorithm(const std::string &name)
 {
@@ -13,9 +20,39 @@ MSTAlgorithm *MSTFactory::createAlgorithm(const std::string &name)
     {
         return new KruskalAlgorithm();
     }
+    else if (name == "Boruvka")
+    {
+        return new BoruvkaAlgorithm();
+    }
+    else if (name == "PrimHeap")
+    {
+        return new IndexedPrimAlgorithm();
+    }
+    else if (name == "FilterKruskal")
+    {
+        return new FilterKruskalAlgorithm();
+    }
+    else if (name == "DensePrim")
+    {
+        return new DensePrimAlgorithm();
+    }
+    else if (name == "Auto")
+    {
+        return new AutoAlgorithm();
+    }
     else
     {
         return nullptr;
     }
     // in case we would like to add more algorithms in the future, we can add them here.
 }
+
+AlgorithmChoice MSTFactory::chooseAlgorithm(const CSRGraph &graph, bool wholeForestOnly)
+{
+    return selector.choose(graph, wholeForestOnly);
+}
+
+void MSTFactory::recordRuntime(const CSRGraph &graph, const std::string &name, double seconds)
+{
+    selector.recordRuntime(graph, name, seconds);
+}
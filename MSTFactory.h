@@ -4,11 +4,21 @@
 
 #include <string>
 #include "MSTAlgorithm.h"
+#include "AlgorithmSelector.h"
 
 class MSTFactory
 {
 public:
+    // "Auto" picks one of the other kernels per graph (see chooseAlgorithm())
     static MSTAlgorithm *createAlgorithm(const std::string &name);
+
+    // The kernel "Auto" would run on this graph now, from the cost model and the runtimes recorded so far;
+    // wholeForestOnly restricts it to kernels that span every component (see AlgorithmSelector)
+    static AlgorithmChoice chooseAlgorithm(const CSRGraph &graph, bool wholeForestOnly = false);
+    static void recordRuntime(const CSRGraph &graph, const std::string &name, double seconds);
+
+private:
+    static AlgorithmSelector selector;
 };
 
 #endif // MSTFACTORY_H
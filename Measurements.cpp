@@ -1,44 +1,53 @@
 #include "Measurements.h"
-#include <queue>
+#include "ParallelFor.h"
 #include <limits>
-#include <iostream>
 #include <vector>
+#include <algorithm>
+#include <atomic>
 #include <functional>
+#include <random>
+#include <chrono>
+#include <cmath>
 
-// Helper function: Run Dijkstra to get distances from 'start' to all other vertices
-static std::vector<double> dijkstraDistances(const Graph &graph, int start)
+// Sources per block in SourceSchedule::Batched
+static const size_t SOURCE_BATCH_SIZE = 64;
+
+// Run Dijkstra to get distances from 'start' to all other vertices
+void DijkstraWorkspace::run(const CSRGraph &graph, int start)
 {
     int n = graph.getNumVertices();
-    std::vector<double> dist(n, std::numeric_limits<double>::infinity());
+    dist.assign(n, std::numeric_limits<double>::infinity());
     dist[start] = 0.0;
 
-    // Min-heap of (distance, node)
-    using NodeDistPair = std::pair<double, int>;
-    std::priority_queue<NodeDistPair, std::vector<NodeDistPair>, std::greater<NodeDistPair>> pq;
-    pq.push({0.0, start});
+    // Min-heap of (distance, node), kept in the reused vector
+    std::greater<std::pair<double, int>> cmp;
+    heap.clear();
+    heap.emplace_back(0.0, start);
 
-    while (!pq.empty())
+    while (!heap.empty())
     {
-        auto [currentDist, node] = pq.top();
-        pq.pop();
+        std::pop_heap(heap.begin(), heap.end(), cmp);
+        double currentDist = heap.back().first;
+        int node = heap.back().second;
+        heap.pop_back();
 
         // If we already found a better path, skip
         if (currentDist > dist[node])
             continue;
 
         // Explore neighbors
-        for (const auto &edge : graph.getAdjEdges(node))
+        for (size_t i = graph.begin(node); i < graph.end(node); ++i)
         {
-            double newDist = currentDist + edge.weight;
-            if (newDist < dist[edge.dest])
+            int next = graph.neighbor(i);
+            double newDist = currentDist + graph.weight(i);
+            if (newDist < dist[next])
             {
-                dist[edge.dest] = newDist;
-                pq.push({newDist, edge.dest});
+                dist[next] = newDist;
+                heap.emplace_back(newDist, next);
+                std::push_heap(heap.begin(), heap.end(), cmp);
             }
         }
     }
-
-    return dist;
 }
 
 // ---------------------------------------------------
@@ -53,86 +62,196 @@ double calculateTotalWeight(const std::vector<Edge> &edges)
     return total;
 }
 
-// Build MST graph from MST edges
-Graph buildMSTGraph(int numVertices, const std::vector<Edge> &edges)
+/**
+ * @brief Calculate average distance over all pairs in a general graph.
+ *
+ * Runs one Dijkstra per source vertex. The sources are spread over one worker
+ * per core; every worker owns a DijkstraWorkspace and a partial sum and count,
+ * which are added up once all workers are done. Sources are handed out from a
+ * shared atomic counter, one at a time or in blocks depending on 'schedule'.
+ */
+double calculateAverageDistance(const CSRGraph &graph, SourceSchedule schedule)
 {
-    Graph mst(numVertices);
-    for (const auto &edge : edges)
-    {
-        mst.addEdge(edge.src, edge.dest, edge.weight);
-    }
-    return mst;
-}
-
-// Calculate distances in MST (longest and shortest among all distinct pairs)
-std::pair<double, double> calculateDistancesInMST(const Graph &mst)
-{
-    int n = mst.getNumVertices();
-    if (n <= 1)
-    {
-        // If there's 0 or 1 vertex, no meaningful pair distances
-        return {0.0, 0.0};
-    }
+    int n = graph.getNumVertices();
+    if (n <= 1) 
+        return 0.0; // 0 or 1 vertex => no meaningful pairs
 
-    double maxDist = 0.0;
-    double minDist = std::numeric_limits<double>::infinity();
+    size_t workers = parallelWorkerCount();
+    size_t step = schedule == SourceSchedule::Batched ? SOURCE_BATCH_SIZE : 1;
+    std::vector<double> partialSums(workers, 0.0);
+    std::vector<size_t> partialCounts(workers, 0);
+    std::atomic<size_t> nextSource(0);
 
-    // For each vertex, run Dijkstra in the MST
-    for (int i = 0; i < n; i++)
-    {
-        std::vector<double> dist = dijkstraDistances(mst, i);
-        for (int j = 0; j < n; j++)
+    parallelFor(0, workers, [&](size_t begin, size_t end, unsigned)
+                {
+        for (size_t worker = begin; worker < end; ++worker)
         {
-            if (i == j) 
-                continue; // skip distance(i,i)=0
+            DijkstraWorkspace workspace;
+            double sumOfDistances = 0.0;
+            size_t count = 0;
 
-            if (dist[j] < std::numeric_limits<double>::infinity())
+            // Claim sources until all of them are taken
+            for (size_t first = nextSource.fetch_add(step); first < static_cast<size_t>(n); first = nextSource.fetch_add(step))
             {
-                if (dist[j] > maxDist)
-                    maxDist = dist[j];
-                if (dist[j] < minDist)
-                    minDist = dist[j];
+                size_t last = std::min(first + step, static_cast<size_t>(n));
+                for (size_t i = first; i < last; ++i)
+                {
+                    workspace.run(graph, static_cast<int>(i));
+                    const std::vector<double> &dist = workspace.distances();
+
+                    // Sum distances to j (where j > i) to avoid double counting
+                    for (int j = static_cast<int>(i) + 1; j < n; j++)
+                    {
+                        if (dist[j] < std::numeric_limits<double>::infinity())
+                        {
+                            sumOfDistances += dist[j];
+                            count++;
+                        }
+                    }
+                }
             }
-        }
+
+            partialSums[worker] = sumOfDistances;
+            partialCounts[worker] = count;
+        } }, 1);
+
+    double sumOfDistances = 0.0;
+    size_t count = 0;
+    for (size_t w = 0; w < workers; ++w)
+    {
+        sumOfDistances += partialSums[w];
+        count += partialCounts[w];
     }
 
-    // If we never updated minDist, it means the MST might be disconnected (shouldn't happen for a proper MST)
-    if (minDist == std::numeric_limits<double>::infinity())
-        minDist = 0.0;
+    // If count == 0, graph might be completely disconnected
+    if (count == 0)
+        return 0.0;
 
-    return {maxDist, minDist};
+    double average = sumOfDistances / static_cast<double>(count);
+    return average;
 }
 
-// Calculate average distance over all pairs in a general graph
-double calculateAverageDistance(const Graph &graph)
+/**
+ * @brief Estimates the average distance over all pairs from a random sample of sources.
+ *
+ * A Dijkstra run from source s yields X_s, the sum of the distances from s to
+ * every vertex it reaches, and C_s, the number of those vertices. The average
+ * over all pairs is sum(X) / sum(C) over all sources, so over a uniform sample
+ * of sources (drawn without replacement) the ratio estimator R = sum(X) / sum(C)
+ * is used. Its standard error follows from the residuals X_s - R * C_s
+ * (delta method) with the finite population correction, and the reported
+ * margin is the 95% half-width, 1.96 standard errors.
+ *
+ * Sources are processed in rounds of one source per worker thread. After every
+ * round the estimator stops when the margin is below settings.targetRelativeError
+ * of the estimate or settings.timeBudgetSeconds is used up. If the budget runs
+ * out before a margin can be formed (no reachable pair yet, or fewer than
+ * settings.minSources sources), the partial ratio is returned with an infinite
+ * margin. If every vertex ends up sampled, the result is exact.
+ */
+AverageDistanceEstimate estimateAverageDistance(const CSRGraph &graph, const ApproximationSettings &settings)
 {
+    AverageDistanceEstimate estimate;
     int n = graph.getNumVertices();
-    if (n <= 1) 
-        return 0.0; // 0 or 1 vertex => no meaningful pairs
+    if (n <= 1)
+        return estimate; // 0 or 1 vertex => no meaningful pairs
 
-    double sumOfDistances = 0.0;
-    int count = 0;
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                                     std::chrono::duration<double>(settings.timeBudgetSeconds));
 
-    // For each vertex, run Dijkstra
-    for (int i = 0; i < n; i++)
-    {
-        std::vector<double> dist = dijkstraDistances(graph, i);
+    size_t workers = parallelWorkerCount();
+    std::vector<DijkstraWorkspace> workspaces(workers);
+    std::vector<int> sources(n); // Shuffled lazily: sources[0..sampled) is the sample so far
+    for (int i = 0; i < n; ++i)
+        sources[i] = i;
+    std::mt19937_64 rng(settings.seed);
+
+    std::vector<double> sampleSums;   // X_s of every sampled source
+    std::vector<double> sampleCounts; // C_s of every sampled source
+    double totalSum = 0.0, totalCount = 0.0;
+    size_t sampled = 0;
 
-        // Sum distances to j (where j > i) to avoid double counting
-        for (int j = i + 1; j < n; j++)
+    while (sampled < static_cast<size_t>(n))
+    {
+        // Draw the next round of sources (partial Fisher-Yates shuffle)
+        size_t roundSize = std::min(workers, static_cast<size_t>(n) - sampled);
+        for (size_t k = sampled; k < sampled + roundSize; ++k)
         {
-            if (dist[j] < std::numeric_limits<double>::infinity())
+            std::uniform_int_distribution<size_t> pick(k, n - 1);
+            std::swap(sources[k], sources[pick(rng)]);
+        }
+
+        sampleSums.resize(sampled + roundSize);
+        sampleCounts.resize(sampled + roundSize);
+        parallelFor(sampled, sampled + roundSize, [&](size_t begin, size_t end, unsigned worker)
+                    {
+            for (size_t k = begin; k < end; ++k)
             {
-                sumOfDistances += dist[j];
-                count++;
-            }
+                workspaces[worker].run(graph, sources[k]);
+                const std::vector<double> &dist = workspaces[worker].distances();
+                double sum = 0.0;
+                size_t count = 0;
+                for (int j = 0; j < n; ++j)
+                {
+                    if (j != sources[k] && dist[j] < std::numeric_limits<double>::infinity())
+                    {
+                        sum += dist[j];
+                        count++;
+                    }
+                }
+                sampleSums[k] = sum;
+                sampleCounts[k] = static_cast<double>(count);
+            } }, 1);
+
+        for (size_t k = sampled; k < sampled + roundSize; ++k)
+        {
+            totalSum += sampleSums[k];
+            totalCount += sampleCounts[k];
         }
-    }
+        sampled += roundSize;
+        if (sampled == static_cast<size_t>(n))
+            break;
 
-    // If count == 0, graph might be completely disconnected
-    if (count == 0)
-        return 0.0;
+        bool outOfTime = Clock::now() >= deadline;
+        if (totalCount == 0.0 || sampled < std::max<size_t>(2, settings.minSources))
+        {
+            if (!outOfTime)
+                continue;
+            // The budget ran out before a confidence interval could be formed
+            estimate.average = totalCount == 0.0 ? 0.0 : totalSum / totalCount;
+            estimate.marginOfError = std::numeric_limits<double>::infinity();
+            estimate.sourcesUsed = sampled;
+            estimate.exact = false;
+            return estimate;
+        }
 
-    double average = sumOfDistances / static_cast<double>(count);
-    return average;
+        // 95% confidence half-width of the ratio estimator
+        double ratio = totalSum / totalCount;
+        double meanCount = totalCount / static_cast<double>(sampled);
+        double squaredResiduals = 0.0;
+        for (size_t k = 0; k < sampled; ++k)
+        {
+            double residual = sampleSums[k] - ratio * sampleCounts[k];
+            squaredResiduals += residual * residual;
+        }
+        double residualVariance = squaredResiduals / static_cast<double>(sampled - 1);
+        double finitePopulation = 1.0 - static_cast<double>(sampled) / static_cast<double>(n);
+        double standardError = std::sqrt(finitePopulation * residualVariance / static_cast<double>(sampled)) / meanCount;
+
+        estimate.average = ratio;
+        estimate.marginOfError = 1.96 * standardError;
+        estimate.sourcesUsed = sampled;
+        estimate.exact = false;
+
+        if (estimate.marginOfError <= settings.targetRelativeError * std::fabs(ratio) || outOfTime)
+            return estimate;
+    }
+
+    // Every source was used: the value is exact
+    estimate.average = totalCount == 0.0 ? 0.0 : totalSum / totalCount;
+    estimate.marginOfError = 0.0;
+    estimate.sourcesUsed = sampled;
+    estimate.exact = true;
+    return estimate;
 }
@@ -3,12 +3,55 @@
 #define MEASUREMENTS_H
 
 #include <vector>
+#include <utility>
+#include <cstddef>
 #include "Edge.h"
-#include "Graph.h"
+#include "CSRGraph.h"
+
+// How calculateAverageDistance hands out Dijkstra sources to its worker threads
+enum class SourceSchedule
+{
+    PerSource, // Workers take one source at a time (finest load balancing)
+    Batched    // Workers take blocks of consecutive sources (better locality, fewer hand-offs)
+};
+
+/**
+ * @brief Distance and heap buffers for repeated single-source Dijkstra runs.
+ *
+ * One workspace per thread; run() reuses the buffers of the previous run
+ * instead of allocating them for every source.
+ */
+class DijkstraWorkspace
+{
+public:
+    void run(const CSRGraph &graph, int start);
+    const std::vector<double> &distances() const { return dist; }
+
+private:
+    std::vector<double> dist;
+    std::vector<std::pair<double, int>> heap; // Min-heap of (distance, node)
+};
+
+// Stopping rules for estimateAverageDistance
+struct ApproximationSettings
+{
+    double targetRelativeError = 0.01; // Stop once the 95% interval half-width is this fraction of the estimate
+    double timeBudgetSeconds = 1.0;    // ... or once this much time has been spent
+    size_t minSources = 32;            // Never stop before this many sources (the interval is unreliable below)
+    unsigned seed = 0;                 // Seed of the source sampling
+};
+
+// Result of an average-distance computation, exact or sampled
+struct AverageDistanceEstimate
+{
+    double average = 0.0;
+    double marginOfError = 0.0; // Half-width of the 95% confidence interval, 0 when exact, infinite when unknown
+    size_t sourcesUsed = 0;     // Dijkstra sources the value is based on
+    bool exact = true;
+};
 
 double calculateTotalWeight(const std::vector<Edge>& edges);
-Graph buildMSTGraph(int numVertices, const std::vector<Edge>& edges);
-std::pair<double, double> calculateDistancesInMST(const Graph& mst);
-double calculateAverageDistance(const Graph& graph);
+double calculateAverageDistance(const CSRGraph& graph, SourceSchedule schedule = SourceSchedule::Batched);
+AverageDistanceEstimate estimateAverageDistance(const CSRGraph& graph, const ApproximationSettings& settings);
 
 #endif // MEASUREMENTS_H
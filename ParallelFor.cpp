@@ -0,0 +1,53 @@
+// ParallelFor.cpp
+#include "ParallelFor.h"
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+unsigned parallelWorkerCount()
+{
+    unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+/**
+ * @brief Fork-join loop over an index range.
+ *
+ * The algorithms call this from inside ThreadPool tasks, so it must not wait
+ * on the pool's own workers (they may all be busy with other clients). It
+ * therefore forks short-lived threads of its own and joins them before
+ * returning.
+ */
+void parallelFor(size_t begin, size_t end,
+                 const std::function<void(size_t, size_t, unsigned)> &body,
+                 size_t minChunk)
+{
+    if (end <= begin)
+        return;
+
+    size_t length = end - begin;
+    size_t workers = std::min<size_t>(parallelWorkerCount(), std::max<size_t>(1, length / std::max<size_t>(1, minChunk)));
+    if (workers <= 1)
+    {
+        body(begin, end, 0);
+        return;
+    }
+
+    size_t chunk = (length + workers - 1) / workers;
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (size_t w = 1; w < workers; ++w)
+    {
+        size_t chunkBegin = begin + w * chunk;
+        size_t chunkEnd = std::min(end, chunkBegin + chunk);
+        if (chunkBegin >= chunkEnd)
+            break;
+        threads.emplace_back([&body, chunkBegin, chunkEnd, w]()
+                             { body(chunkBegin, chunkEnd, static_cast<unsigned>(w)); });
+    }
+
+    body(begin, std::min(end, begin + chunk), 0);
+
+    for (std::thread &t : threads)
+        t.join();
+}
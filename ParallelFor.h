@@ -0,0 +1,21 @@
+// ParallelFor.h
+#ifndef PARALLELFOR_H
+#define PARALLELFOR_H
+
+#include <cstddef>
+#include <functional>
+
+// Number of workers parallelFor splits a range into (one per hardware thread)
+unsigned parallelWorkerCount();
+
+/**
+ * Splits [begin, end) into one contiguous chunk per worker and runs
+ * body(chunkBegin, chunkEnd, workerIndex) on all chunks concurrently. The
+ * calling thread runs chunk 0 itself; the call returns when every chunk is done.
+ * Ranges shorter than minChunk per worker use fewer workers.
+ */
+void parallelFor(size_t begin, size_t end,
+                 const std::function<void(size_t, size_t, unsigned)> &body,
+                 size_t minChunk = 1024);
+
+#endif // PARALLELFOR_H
@@ -0,0 +1,52 @@
+// PipelineStage.cpp
+#include "PipelineStage.h"
+
+/**
+ * @brief Starts 'replicaCount' threads for the stage (at least one). Replica
+ * r of stage s reports itself as ActiveObject thread s * 10 + r.
+ */
+PipelineStage::PipelineStage(int stageNumber, size_t replicaCount) : nextReplica(0)
+{
+    if (replicaCount == 0)
+        replicaCount = 1;
+    for (size_t r = 0; r < replicaCount; ++r)
+        replicas.emplace_back(new ActiveObject(stageNumber * 10 + static_cast<int>(r)));
+}
+
+/**
+ * @brief Hands a task to the least loaded replica.
+ */
+void PipelineStage::enqueue(Task task)
+{
+    size_t count = replicas.size();
+    size_t start = nextReplica.fetch_add(1, std::memory_order_relaxed) % count;
+    size_t best = start;
+    size_t bestDepth = replicas[start]->getQueueDepth();
+    for (size_t i = 1; i < count && bestDepth > 0; ++i)
+    {
+        size_t r = (start + i) % count;
+        size_t depth = replicas[r]->getQueueDepth();
+        if (depth < bestDepth)
+        {
+            best = r;
+            bestDepth = depth;
+        }
+    }
+    replicas[best]->enqueue(std::move(task));
+}
+
+StageStatistics PipelineStage::getStatistics() const
+{
+    StageStatistics statistics;
+    uint64_t busyNanoseconds = 0;
+    statistics.replicas = replicas.size();
+    for (const auto &replica : replicas)
+    {
+        statistics.queueDepth += replica->getQueueDepth();
+        statistics.completedTasks += replica->getCompletedTasks();
+        busyNanoseconds += replica->getBusyNanoseconds();
+    }
+    if (statistics.completedTasks > 0)
+        statistics.meanServiceMilliseconds = busyNanoseconds / 1e6 / static_cast<double>(statistics.completedTasks);
+    return statistics;
+}
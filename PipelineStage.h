@@ -0,0 +1,41 @@
+// PipelineStage.h
+#ifndef PIPELINESTAGE_H
+#define PIPELINESTAGE_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include "ActiveObject.h"
+#include "Task.h"
+
+// Load of one pipeline stage, summed over its replicas
+struct StageStatistics
+{
+    size_t replicas = 0;
+    size_t queueDepth = 0;                // Tasks waiting or running right now
+    uint64_t completedTasks = 0;
+    double meanServiceMilliseconds = 0.0; // Mean time one task ran
+};
+
+/**
+ * @brief One pipeline stage served by one or more ActiveObject replicas.
+ *
+ * Each task goes to the replica with the fewest queued tasks, scanning from a
+ * rotating start so equally loaded replicas take turns. Tasks of one stage may
+ * therefore finish out of order; callers that need an order restore it
+ * themselves (the response stage does, per client, via reply tickets).
+ */
+class PipelineStage
+{
+public:
+    PipelineStage(int stageNumber, size_t replicaCount);
+    void enqueue(Task task);
+    StageStatistics getStatistics() const;
+
+private:
+    std::vector<std::unique_ptr<ActiveObject>> replicas;
+    std::atomic<size_t> nextReplica;
+};
+
+#endif // PIPELINESTAGE_H
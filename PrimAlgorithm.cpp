@@ -1,90 +1,173 @@
 // PrimAlgorithm.cpp
 #include "PrimAlgorithm.h"
+#include "BucketQueue.h"
 #include <queue>
 #include <functional>
-#include <sstream>
 
-/**
- * @brief Computes the Minimum Spanning Tree (MST) of a graph using Prim's algorithm.
- * 
- * This function implements Prim's algorithm to find the MST of the given graph.
- * It starts from vertex 0 and proceeds to add the smallest edge connecting a 
- * vertex inside the MST to a vertex outside the MST until the MST spans all 
- * vertices. The function maintains a priority queue to efficiently select the 
- * next edge with the minimum weight.
- * 
- * @param graph The input graph represented as an adjacency list.
- * 
- * @return A vector of edges representing the MST of the input graph.
- */
-
-std::vector<Edge> PrimAlgorithm::computeMST(Graph &graph)
+namespace
 {
-    size_t V = graph.getNumVertices();
-    // Keep track of which vertices are already included in the MST
-    std::vector<bool> inMST(V, false);
-    std::vector<Edge> mstEdges;
+    /**
+     * Prim's algorithm with a priority queue of edges, on weights of type W.
+     * Every scanned edge is pushed as a WeightedEdge<W> (12 bytes for 4-byte
+     * weights instead of a 16-byte Edge) and stale entries are skipped when
+     * they are popped.
+     */
+    template <typename W>
+    std::vector<Edge> queuePrim(const CSRGraph &graph, const W *weights, ComputationTrace &trace)
+    {
+        size_t V = graph.getNumVertices();
+        std::vector<Edge> mstEdges;
+        if (V == 0)
+            return mstEdges;
+        // Keep track of which vertices are already included in the MST
+        std::vector<bool> inMST(V, false);
 
-    // Create a min-heap (priority queue) to efficiently select the next
-    // edge with the minimum weight. The heap is ordered by the edge weights.
-    auto comp = [](Edge &e1, Edge &e2)
-    { return e1.weight > e2.weight; };
-    std::priority_queue<Edge, std::vector<Edge>, decltype(comp)> pq(comp);
+        // Create a min-heap (priority queue) to efficiently select the next
+        // edge with the minimum weight. The heap is ordered by the edge weights.
+        auto comp = [](const WeightedEdge<W> &e1, const WeightedEdge<W> &e2)
+        { return e1.weight > e2.weight; };
+        std::priority_queue<WeightedEdge<W>, std::vector<WeightedEdge<W>>, decltype(comp)> pq(comp);
 
-    // Create a log to store computation steps
-    std::stringstream log;
-    log << "Starting Prim's algorithm:\n";
+        // Start from vertex 0, which is always included in the MST
+        inMST[0] = true;
+        trace.note("Include vertex 0 in MST.");
+        // Add all adjacent edges of vertex 0 to the priority queue
+        for (size_t i = graph.begin(0); i < graph.end(0); ++i)
+        {
+            WeightedEdge<W> edge(0, graph.neighbor(i), weights[i]);
+            pq.push(edge);
+            trace.event(TraceEvent::Push, edge.src, edge.dest, edge.weight);
+        }
 
-    // Start from vertex 0, which is always included in the MST
-    inMST[0] = true;
-    log << "Include vertex 0 in MST.\n";
-    // Add all adjacent edges of vertex 0 to the priority queue
-    for (auto &edge : graph.getAdjEdges(0))
-    {
-        pq.push(edge);
-        log << "Add edge (" << edge.src << ", " << edge.dest << ") with weight " << edge.weight << " to the priority queue.\n";
+        // While the priority queue is not empty and we still need to select
+        // more edges to complete the MST
+        while (!pq.empty() && mstEdges.size() < V - 1)
+        {
+            // Select the edge with the minimum weight from the priority queue
+            WeightedEdge<W> edge = pq.top();
+            pq.pop();
+
+            // v is the destination vertex of the selected edge
+            int v = edge.dest;
+            // If v is not yet included in the MST
+            if (!inMST[v])
+            {
+                // Include v in the MST
+                inMST[v] = true;
+                // Add the selected edge to the MST
+                mstEdges.push_back(edge.toEdge());
+                trace.event(TraceEvent::Include, edge.src, edge.dest, edge.weight);
+
+                // Add all adjacent edges of v to the priority queue
+                for (size_t i = graph.begin(v); i < graph.end(v); ++i)
+                {
+                    // If the adjacent edge is not yet included in the MST
+                    if (!inMST[graph.neighbor(i)])
+                    {
+                        // Add it to the priority queue
+                        WeightedEdge<W> adjEdge(v, graph.neighbor(i), weights[i]);
+                        pq.push(adjEdge);
+                        trace.event(TraceEvent::Push, adjEdge.src, adjEdge.dest, adjEdge.weight);
+                    }
+                }
+            }
+        }
+
+        return mstEdges;
     }
 
-    // While the priority queue is not empty and we still need to select
-    // more edges to complete the MST
-    while (!pq.empty() && mstEdges.size() < V - 1)
+    /**
+     * Prim's algorithm for small integer weights (Dial's algorithm). Every
+     * vertex outside the tree is in the bucket of its cheapest known connecting
+     * edge, at most once, and a cheaper edge moves it to a lower bucket, so
+     * there is no comparison and no heap; the queue holds at most V entries.
+     */
+    std::vector<Edge> bucketPrim(const CSRGraph &graph, const uint32_t *weights, ComputationTrace &trace)
     {
-        // Select the edge with the minimum weight from the priority queue
-        Edge edge = pq.top();
-        pq.pop();
+        int V = graph.getNumVertices();
+        std::vector<Edge> mstEdges;
+        if (V == 0)
+            return mstEdges;
+
+        std::vector<bool> inMST(V, false);
+        std::vector<int> parent(V, -1); // Tree endpoint of each vertex's current key
+        IndexedBucketQueue queue(V, graph.getMaxIntegerWeight());
 
-        // v is the destination vertex of the selected edge
-        int v = edge.dest;
-        // If v is not yet included in the MST
-        if (!inMST[v])
+        trace.note("Include vertex 0 in MST.");
+        queue.push(0, 0);
+        while (!queue.empty())
         {
-            // Include v in the MST
-            inMST[v] = true;
-            // Add the selected edge to the MST
-            mstEdges.push_back(edge);
-            log << "Include edge (" << edge.src << ", " << edge.dest << ") with weight " << edge.weight << " in MST.\n";
+            // The vertex with the cheapest connecting edge joins the tree
+            int u = queue.pop();
+            inMST[u] = true;
+            if (parent[u] != -1)
+            {
+                mstEdges.emplace_back(parent[u], u, queue.key(u));
+                trace.event(TraceEvent::Include, mstEdges.back());
+            }
 
-            // Add all adjacent edges of v to the priority queue
-            for (auto &adjEdge : graph.getAdjEdges(v))
+            // Relax the edges to vertices still outside the tree
+            for (size_t i = graph.begin(u); i < graph.end(u); ++i)
             {
-                // If the adjacent edge is not yet included in the MST
-                if (!inMST[adjEdge.dest])
+                int v = graph.neighbor(i);
+                uint32_t w = weights[i];
+                if (inMST[v])
+                    continue;
+                if (!queue.contains(v))
+                {
+                    parent[v] = u;
+                    queue.push(v, w);
+                    trace.event(TraceEvent::SetKey, u, v, w);
+                }
+                else if (w < queue.key(v))
                 {
-                    // Add it to the priority queue
-                    pq.push(adjEdge);
-                    log << "Add edge (" << adjEdge.src << ", " << adjEdge.dest << ") with weight " << adjEdge.weight << " to the priority queue.\n";
+                    parent[v] = u;
+                    queue.decreaseKey(v, w);
+                    trace.event(TraceEvent::LowerKey, u, v, w);
                 }
             }
         }
-    }
-
-    // Store the log for later retrieval
-    computationLog = log.str();
 
-    return mstEdges;
+        return mstEdges;
+    }
 }
 
-std::string PrimAlgorithm::getComputationLog() const
+/**
+ * @brief Computes the Minimum Spanning Tree (MST) of a graph using Prim's algorithm.
+ *
+ * This function implements Prim's algorithm to find the MST of the given graph.
+ * It starts from vertex 0 and proceeds to add the smallest edge connecting a
+ * vertex inside the MST to a vertex outside the MST until the MST spans all
+ * vertices. The function maintains a priority queue to efficiently select the
+ * next edge with the minimum weight.
+ *
+ * The kernel is chosen once, by the graph's weight type: whole-number weights
+ * up to BUCKET_QUEUE_MAX_WEIGHT use a bucket queue, other weights that fit 4
+ * bytes a priority queue of 4-byte weights, and the rest one of doubles.
+ *
+ * @param graph The input graph in compressed-sparse-row form.
+ * @param trace Receives every push onto the priority queue (or key change in
+ * the bucket queue) and every included edge.
+ *
+ * @return A vector of edges representing the MST of the input graph.
+ */
+std::vector<Edge> PrimAlgorithm::computeMST(const CSRGraph &graph, ComputationTrace &trace)
 {
-    return computationLog;
+    switch (graph.getWeightType())
+    {
+    case WeightType::UInt32:
+        if (graph.getMaxIntegerWeight() <= BUCKET_QUEUE_MAX_WEIGHT)
+        {
+            trace.note("Starting Prim's algorithm (integer weights, bucket queue):");
+            return bucketPrim(graph, graph.getWeightsAs<uint32_t>(), trace);
+        }
+        trace.note("Starting Prim's algorithm (integer weights):");
+        return queuePrim(graph, graph.getWeightsAs<uint32_t>(), trace);
+    case WeightType::Float:
+        trace.note("Starting Prim's algorithm (float weights):");
+        return queuePrim(graph, graph.getWeightsAs<float>(), trace);
+    default:
+        trace.note("Starting Prim's algorithm:");
+        return queuePrim(graph, graph.getWeights(), trace);
+    }
 }
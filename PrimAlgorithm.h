@@ -6,10 +6,11 @@
 
 class PrimAlgorithm : public MSTAlgorithm {
 public:
-    std::vector<Edge> computeMST(Graph& graph) override;
-    std::string getComputationLog() const override;  // Implemented method
-private:
-    std::string computationLog;  // Stores computation steps
+    // Integer weights up to this go into a bucket queue; with larger ones scanning empty buckets would dominate
+    static const uint32_t BUCKET_QUEUE_MAX_WEIGHT = 65535;
+
+    std::vector<Edge> computeMST(const CSRGraph& graph, ComputationTrace& trace) override;
+    std::string getName() const override { return "Prim"; }
 };
 
 #endif // PRIMALGORITHM_H
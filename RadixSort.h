@@ -0,0 +1,70 @@
+// RadixSort.h
+#ifndef RADIXSORT_H
+#define RADIXSORT_H
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+// Unsigned 32-bit key that orders like the weight itself
+inline uint32_t radixKey(uint32_t weight)
+{
+    return weight;
+}
+
+// Flips the sign bit of non-negative floats and all bits of negative ones, so the keys order like the floats
+inline uint32_t radixKey(float weight)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &weight, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+/**
+ * @brief Sorts items by a 32-bit key in linear time (least significant digit
+ * radix sort, four passes of 8 bits).
+ *
+ * Each pass counts the digits and scatters the items into 'scratch', then the
+ * two arrays swap roles. A pass whose digit is the same for every item would
+ * not move anything and is skipped, so small keys, e.g. integer weights below
+ * 65536, take two passes. The sort is stable.
+ *
+ * @param key Returns the uint32_t key of an item.
+ */
+template <typename T, typename Key>
+void radixSort(std::vector<T> &items, std::vector<T> &scratch, Key key)
+{
+    const size_t n = items.size();
+    size_t counts[4][256] = {};
+    for (const T &item : items)
+    {
+        uint32_t k = key(item);
+        for (int pass = 0; pass < 4; ++pass)
+            ++counts[pass][(k >> (8 * pass)) & 0xff];
+    }
+
+    scratch.resize(n);
+    for (int pass = 0; pass < 4; ++pass)
+    {
+        size_t *count = counts[pass];
+        bool trivial = false;
+        for (int digit = 0; digit < 256; ++digit)
+            trivial = trivial || count[digit] == n;
+        if (trivial)
+            continue;
+
+        size_t offset = 0;
+        for (int digit = 0; digit < 256; ++digit)
+        {
+            size_t c = count[digit];
+            count[digit] = offset;
+            offset += c;
+        }
+        for (const T &item : items)
+            scratch[count[(key(item) >> (8 * pass)) & 0xff]++] = item;
+        items.swap(scratch);
+    }
+}
+
+#endif // RADIXSORT_H
@@ -0,0 +1,705 @@
+// Reactor.cpp
+#include "Reactor.h"
+#include "Logger.h"
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <unistd.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+namespace
+{
+    // epoll user data of the two descriptors that are not client connections;
+    // connection ids start at 1 and never reach WAKE_EVENT
+    const ConnectionId LISTEN_EVENT = 0;
+    const ConnectionId WAKE_EVENT = ~static_cast<ConnectionId>(0);
+
+    const int MAX_EVENTS = 256;
+
+    void throwSystemError(const char *what)
+    {
+        throw std::runtime_error(std::string(what) + ": " + strerror(errno));
+    }
+}
+
+
+const size_t Reactor::MAX_LINE_LENGTH;
+
+/**
+ * @brief Registers the listening socket and a wake-up eventfd with a new epoll
+ * instance. The listening socket is switched to non-blocking mode and is
+ * closed by the destructor.
+ */
+Reactor::Reactor(int listenSocket, ConnectHandler onConnect, InputHandler onInput, BulkGate acceptsBulk,
+                 BulkHandler onBulk, DisconnectHandler onDisconnect, int64_t maxBulkEdges)
+    : listenSocket(listenSocket), epollFd(-1), wakeFd(-1), onConnect(onConnect), onInput(onInput),
+      acceptsBulk(acceptsBulk), onBulk(onBulk), onDisconnect(onDisconnect), maxBulkEdges(std::min(maxBulkEdges, BULK_MAX_EDGES)),
+      stopping(false), nextConnection(1)
+{
+    int flags = fcntl(listenSocket, F_GETFL, 0);
+    if (flags < 0 || fcntl(listenSocket, F_SETFL, flags | O_NONBLOCK) < 0)
+        throwSystemError("fcntl");
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0)
+        throwSystemError("epoll_create1");
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd < 0)
+        throwSystemError("eventfd");
+
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.u64 = LISTEN_EVENT;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, listenSocket, &event) < 0)
+        throwSystemError("epoll_ctl");
+    event.data.u64 = WAKE_EVENT;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event) < 0)
+        throwSystemError("epoll_ctl");
+}
+
+Reactor::~Reactor()
+{
+    for (auto &entry : connections)
+        close(entry.second->socket);
+    if (wakeFd >= 0)
+        close(wakeFd);
+    if (epollFd >= 0)
+        close(epollFd);
+    close(listenSocket);
+}
+
+/**
+ * @brief Waits for socket events and dispatches them until stop() is called.
+ *
+ * Errors and hang-ups close the connection. Output produced on this thread
+ * while handling the events is written at the end of each iteration.
+ */
+void Reactor::run()
+{
+    reactorThread = std::this_thread::get_id();
+    std::vector<epoll_event> events(MAX_EVENTS);
+    while (!stopping.load(std::memory_order_acquire))
+    {
+        int ready = epoll_wait(epollFd, events.data(), MAX_EVENTS, -1);
+        if (ready < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throwSystemError("epoll_wait");
+        }
+
+        for (int i = 0; i < ready; ++i)
+        {
+            ConnectionId connection = events[i].data.u64;
+            if (connection == LISTEN_EVENT)
+            {
+                acceptConnections();
+                continue;
+            }
+            if (connection == WAKE_EVENT)
+            {
+                uint64_t count;
+                while (read(wakeFd, &count, sizeof(count)) > 0)
+                {
+                }
+                resumePaused();
+                continue;
+            }
+
+            std::shared_ptr<Connection> client = findConnection(connection);
+            if (!client)
+                continue; // Closed earlier in this batch
+            if (events[i].events & (EPOLLERR | EPOLLHUP))
+            {
+                closeConnection(connection);
+                continue;
+            }
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP))
+                readFromClient(connection, client);
+            if ((events[i].events & EPOLLOUT) && findConnection(connection))
+                flushOutput(connection, client);
+        }
+
+        flushDeferred();
+    }
+}
+
+// Makes run() return; callable from any thread
+void Reactor::stop()
+{
+    stopping.store(true, std::memory_order_release);
+    wake();
+}
+
+/**
+ * @brief Queues data for a client, after every reply reserved before.
+ */
+void Reactor::sendToClient(ConnectionId connection, const std::string &data)
+{
+    std::shared_ptr<Connection> client = findConnection(connection);
+    if (!client)
+        return; // Disconnected while its request was being computed
+
+    uint64_t ticket;
+    {
+        std::lock_guard<std::mutex> lock(client->outputMutex);
+        ticket = client->nextTicket++;
+    }
+    deliver(connection, client, ticket, data, true);
+}
+
+uint64_t Reactor::reserveReply(ConnectionId connection)
+{
+    std::shared_ptr<Connection> client = findConnection(connection);
+    if (!client)
+        return 0;
+
+    std::lock_guard<std::mutex> lock(client->outputMutex);
+    return client->nextTicket++;
+}
+
+void Reactor::sendReply(ConnectionId connection, uint64_t ticket, const std::string &data)
+{
+    std::shared_ptr<Connection> client = findConnection(connection);
+    if (client)
+        deliver(connection, client, ticket, data, true);
+}
+
+bool Reactor::sendReplyPart(ConnectionId connection, uint64_t ticket, const std::string &data)
+{
+    std::shared_ptr<Connection> client = findConnection(connection);
+    if (!client)
+        return false;
+    deliver(connection, client, ticket, data, false);
+
+    // Parts held until the earlier places are filled in count as well, so a stream is never buffered whole.
+    // Waiting for the earlier places is safe: they belong to requests that had their MST before this one was
+    // read, so what is left of them runs on other threads than the caller's
+    std::unique_lock<std::mutex> lock(client->outputMutex);
+    client->outputDrained.wait(lock, [&client, ticket]()
+                               {
+        if (client->closed)
+            return true;
+        auto held = client->heldReplies.find(ticket);
+        size_t heldBytes = held == client->heldReplies.end() ? 0 : held->second.data.size();
+        return client->output.size() + heldBytes <= MAX_STREAM_BACKLOG; });
+    return !client->closed && !client->closeWhenFlushed;
+}
+
+/**
+ * @brief Puts the data of one place in the reply order into the output buffer,
+ * or holds it until the places before it are filled in.
+ *
+ * A place is only done once its data is complete; parts of it go out as they
+ * come, and the places after it wait.
+ *
+ * From another thread the output is written right away, as far as the socket
+ * takes it; on the reactor thread it is written at the end of the current
+ * event loop iteration. The rest is written when the socket becomes writable.
+ */
+void Reactor::deliver(ConnectionId connection, const std::shared_ptr<Connection> &client, uint64_t ticket,
+                      const std::string &data, bool complete)
+{
+    std::lock_guard<std::mutex> lock(client->outputMutex);
+    if (client->closed)
+        return;
+
+    bool wasEmpty = client->output.empty();
+    if (ticket != client->nextDelivered)
+    {
+        HeldReply &held = client->heldReplies[ticket];
+        held.data += data;
+        held.complete = complete;
+        return;
+    }
+    client->output += data;
+    if (complete)
+    {
+        client->heldReplies.erase(ticket); // Emptied when it became this place's turn
+        ++client->nextDelivered;
+        for (auto it = client->heldReplies.begin();
+             it != client->heldReplies.end() && it->first == client->nextDelivered;
+             it = client->heldReplies.erase(it))
+        {
+            client->output += it->second.data;
+            if (!it->second.complete)
+            {
+                it->second.data.clear(); // Still being streamed; its next parts go straight out
+                break;
+            }
+            ++client->nextDelivered;
+        }
+    }
+
+    if (std::this_thread::get_id() == reactorThread)
+    {
+        if (!client->flushQueued)
+        {
+            client->flushQueued = true;
+            deferredFlushes.push_back(connection);
+        }
+        return;
+    }
+    if (!wasEmpty)
+        return; // Already waiting for EPOLLOUT or a deferred flush, which write in order
+
+    if (!writePending(*client))
+    {
+        // Broken connection: let the reactor thread notice and close it
+        client->output.clear();
+        client->closeWhenFlushed = true;
+    }
+    client->outputDrained.notify_all();
+    updateInterest(*client, connection);
+}
+
+// Closes the connection after everything sent to it so far has been written
+void Reactor::closeClient(ConnectionId connection)
+{
+    std::shared_ptr<Connection> client = findConnection(connection);
+    if (!client)
+        return;
+
+    std::lock_guard<std::mutex> lock(client->outputMutex);
+    if (client->closed)
+        return;
+    client->closeWhenFlushed = true;
+    updateInterest(*client, connection); // The reactor closes it on the next EPOLLOUT
+}
+
+void Reactor::pauseInput(ConnectionId connection)
+{
+    std::shared_ptr<Connection> client = findConnection(connection);
+    if (!client)
+        return;
+
+    std::lock_guard<std::mutex> lock(client->outputMutex);
+    client->paused = true;
+    updateInterest(*client, connection);
+}
+
+void Reactor::resumeInput(ConnectionId connection)
+{
+    {
+        std::lock_guard<std::mutex> lock(resumeMutex);
+        resumed.push_back(connection);
+    }
+    wake();
+}
+
+// Accepts every pending connection on the listening socket
+void Reactor::acceptConnections()
+{
+    while (true)
+    {
+        sockaddr_in clientAddr;
+        socklen_t clientAddrSize = sizeof(clientAddr);
+        int clientSocket = accept4(listenSocket, (struct sockaddr *)&clientAddr, &clientAddrSize,
+                                   SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (clientSocket < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                LOG_WARNING("accept: " << std::strerror(errno));
+            return;
+        }
+
+        std::shared_ptr<Connection> client = std::make_shared<Connection>(clientSocket);
+        ConnectionId connection;
+        {
+            std::lock_guard<std::mutex> lock(connectionsMutex);
+            connection = nextConnection++;
+            connections[connection] = client;
+        }
+
+        epoll_event event = {};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.u64 = connection;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, clientSocket, &event) < 0)
+        {
+            LOG_WARNING("epoll_ctl: " << std::strerror(errno));
+            closeConnection(connection);
+            continue;
+        }
+        client->interest = event.events;
+
+        LOG_INFO("Accepted new client connection " << connection << ".");
+        onConnect(connection);
+    }
+}
+
+/**
+ * @brief Reads what the client has sent and dispatches the complete lines.
+ *
+ * Reading stops as soon as the connection is paused, so a client that
+ * pipelines a large upload behind a compute request is held back by TCP flow
+ * control rather than by server memory. The records of a bulk upload are
+ * received directly into their final array, which is only grown once the
+ * records that fill it have arrived.
+ */
+void Reactor::readFromClient(ConnectionId connection, const std::shared_ptr<Connection> &client)
+{
+    char buffer[65536];
+    while (true)
+    {
+        ssize_t bytesReceived;
+        if (client->receivingBulk)
+        {
+            size_t capacity = client->bulkEdges.size() * sizeof(BulkEdge);
+            if (client->bulkReceived < capacity)
+            {
+                char *records = reinterpret_cast<char *>(client->bulkEdges.data());
+                bytesReceived = recv(client->socket, records + client->bulkReceived, capacity - client->bulkReceived, 0);
+            }
+            else
+            {
+                // The array is full: grow it only once more records have actually arrived
+                size_t remaining = static_cast<size_t>(client->bulkHeader.numEdges) * sizeof(BulkEdge) - capacity;
+                bytesReceived = recv(client->socket, buffer, std::min(sizeof(buffer), remaining), 0);
+                if (bytesReceived > 0)
+                {
+                    if (!growBulk(connection, client, bytesReceived))
+                        return;
+                    std::memcpy(reinterpret_cast<char *>(client->bulkEdges.data()) + client->bulkReceived, buffer,
+                                bytesReceived);
+                }
+            }
+            if (bytesReceived > 0)
+            {
+                receiveBulk(connection, client, bytesReceived);
+                if (!dispatchLines(connection, client))
+                    return;
+                continue;
+            }
+        }
+        else
+        {
+            bytesReceived = recv(client->socket, buffer, sizeof(buffer), 0);
+        }
+        if (bytesReceived < 0 && errno == EINTR)
+            continue;
+        if (bytesReceived < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return; // Drained
+        if (bytesReceived < 0)
+        {
+            closeConnection(connection);
+            return;
+        }
+        if (bytesReceived == 0)
+        {
+            // The client is done sending; answer what it sent, then close
+            {
+                std::lock_guard<std::mutex> lock(client->outputMutex);
+                client->peerClosed = true;
+            }
+            dispatchLines(connection, client);
+            return;
+        }
+
+        client->framer.append(buffer, bytesReceived);
+        if (!dispatchLines(connection, client))
+            return;
+    }
+}
+
+/**
+ * @brief Passes buffered complete lines to the input handler, in order, until
+ * they run out or the connection is paused or closing. A buffered command
+ * that starts with BULK_MAGIC begins a bulk upload instead, if the bulk gate
+ * accepts one from the connection at this point; otherwise it is a line.
+ * @return true if the connection still accepts input.
+ */
+bool Reactor::dispatchLines(ConnectionId connection, const std::shared_ptr<Connection> &client)
+{
+    std::string line;
+    while (true)
+    {
+        {
+            std::lock_guard<std::mutex> lock(client->outputMutex);
+            if (client->paused || client->closeWhenFlushed)
+                break;
+        }
+        if (client->receivingBulk)
+            break; // The rest of the records is still on its way
+        // The buffer starts at a command boundary: everything before it was dispatched as whole lines
+        if (client->framer.pendingSize() >= sizeof(BULK_MAGIC) && isBulkMagic(client->framer.pending()) &&
+            acceptsBulk(connection))
+        {
+            if (client->framer.pendingSize() < sizeof(BulkHeader) || !beginBulk(connection, client))
+                break; // Header incomplete, or invalid and the connection is closing
+            continue;
+        }
+        if (!client->framer.nextLine(line))
+        {
+            if (client->framer.overflowed())
+            {
+                sendToClient(connection, "Input line too long.\n");
+                closeClient(connection);
+            }
+            break;
+        }
+        onInput(connection, line);
+    }
+
+    std::lock_guard<std::mutex> lock(client->outputMutex);
+    if (client->closeWhenFlushed)
+        client->framer.clear(); // Input after "Exit" or an error is ignored
+    else if (!client->paused && client->peerClosed)
+        client->closeWhenFlushed = true;
+    updateInterest(*client, connection);
+    return !client->paused && !client->closeWhenFlushed;
+}
+
+/**
+ * @brief Starts a bulk upload from the header at the front of the line buffer.
+ *
+ * Records that arrived in the same reads as the header are moved out of the
+ * line buffer; readFromClient() receives the rest in place. The record array
+ * grows with the data received, so a header alone cannot make the server
+ * allocate the whole upload.
+ *
+ * @return false if the header is invalid; the client is told and disconnected,
+ * since the rest of its stream cannot be interpreted any more.
+ */
+bool Reactor::beginBulk(ConnectionId connection, const std::shared_ptr<Connection> &client)
+{
+    BulkHeader header;
+    std::memcpy(&header, client->framer.pending(), sizeof(header));
+    client->framer.consume(sizeof(header));
+
+    if (header.numVertices < 0 || header.numEdges < 0 || header.numEdges > maxBulkEdges)
+    {
+        client->framer.clear();
+        sendToClient(connection, "Invalid binary upload header.\n");
+        closeClient(connection);
+        return false;
+    }
+
+    client->receivingBulk = true;
+    client->bulkHeader = header;
+    client->bulkEdges.clear();
+    client->bulkReceived = 0;
+
+    size_t total = static_cast<size_t>(header.numEdges) * sizeof(BulkEdge);
+    size_t buffered = std::min(total, client->framer.pendingSize());
+    if (buffered > 0)
+    {
+        if (!growBulk(connection, client, buffered))
+            return false;
+        std::memcpy(client->bulkEdges.data(), client->framer.pending(), buffered);
+        client->framer.consume(buffered);
+    }
+    receiveBulk(connection, client, buffered);
+    return true;
+}
+
+/**
+ * @brief Grows the record array of a bulk upload to hold 'bytes' more bytes than
+ * received so far, doubling it but never past the size in the header.
+ * @return false if the memory is not available; the upload is refused and the
+ * client disconnected, as for an invalid header.
+ */
+bool Reactor::growBulk(ConnectionId connection, const std::shared_ptr<Connection> &client, size_t bytes)
+{
+    size_t needed = (client->bulkReceived + bytes + sizeof(BulkEdge) - 1) / sizeof(BulkEdge);
+    size_t records = std::max(needed, 2 * client->bulkEdges.size());
+    if (records < BULK_GROWTH_RECORDS)
+        records = BULK_GROWTH_RECORDS;
+    records = std::min(records, static_cast<size_t>(client->bulkHeader.numEdges));
+    if (records <= client->bulkEdges.size())
+        return true;
+    try
+    {
+        client->bulkEdges.reserve(records); // Exactly, where resize() alone may double the capacity
+        client->bulkEdges.resize(records);
+    }
+    catch (const std::bad_alloc &)
+    {
+        LOG_WARNING("Refused a binary upload of " << client->bulkHeader.numEdges << " edges: out of memory.");
+        std::vector<BulkEdge>().swap(client->bulkEdges);
+        client->receivingBulk = false;
+        client->bulkReceived = 0;
+        client->framer.clear();
+        sendToClient(connection, "Binary upload refused: the server is out of memory.\n");
+        closeClient(connection);
+        return false;
+    }
+    return true;
+}
+
+// Accounts for 'bytes' more record bytes; passes the upload on once it is complete
+void Reactor::receiveBulk(ConnectionId connection, const std::shared_ptr<Connection> &client, size_t bytes)
+{
+    client->bulkReceived += bytes;
+    if (client->bulkReceived < static_cast<size_t>(client->bulkHeader.numEdges) * sizeof(BulkEdge))
+        return;
+
+    std::vector<BulkEdge> edges;
+    edges.swap(client->bulkEdges);
+    client->receivingBulk = false;
+    client->bulkReceived = 0;
+    onBulk(connection, client->bulkHeader, std::move(edges));
+}
+
+// Continues the connections passed to resumeInput() with their held-back lines
+void Reactor::resumePaused()
+{
+    std::vector<ConnectionId> ready;
+    {
+        std::lock_guard<std::mutex> lock(resumeMutex);
+        ready.swap(resumed);
+    }
+
+    for (ConnectionId connection : ready)
+    {
+        std::shared_ptr<Connection> client = findConnection(connection);
+        if (!client)
+            continue;
+        {
+            std::lock_guard<std::mutex> lock(client->outputMutex);
+            client->paused = false;
+        }
+        dispatchLines(connection, client); // Re-arms EPOLLIN for whatever is still unread
+    }
+}
+
+// Writes buffered output; closes the connection if it asked for it and all is written
+void Reactor::flushOutput(ConnectionId connection, const std::shared_ptr<Connection> &client)
+{
+    bool closeNow;
+    {
+        std::lock_guard<std::mutex> lock(client->outputMutex);
+        client->flushQueued = false;
+        if (!writePending(*client))
+        {
+            client->output.clear();
+            client->closeWhenFlushed = true;
+        }
+        client->outputDrained.notify_all(); // A streaming reply may continue
+        closeNow = client->output.empty() && client->closeWhenFlushed &&
+                   client->nextDelivered == client->nextTicket;
+        if (!closeNow)
+            updateInterest(*client, connection);
+    }
+    if (closeNow)
+        closeConnection(connection);
+}
+
+// Writes the output the reactor thread produced during this event loop iteration
+void Reactor::flushDeferred()
+{
+    std::vector<ConnectionId> pending;
+    pending.swap(deferredFlushes);
+    for (ConnectionId connection : pending)
+    {
+        std::shared_ptr<Connection> client = findConnection(connection);
+        if (client)
+            flushOutput(connection, client);
+    }
+}
+
+/**
+ * @brief Forgets a connection and closes its socket. Reactor thread only.
+ *
+ * The connection is first removed from the map, so no new sender can find it,
+ * and then marked closed under its output lock, so a sender that found it
+ * earlier cannot write to a descriptor that may already belong to someone else.
+ */
+void Reactor::closeConnection(ConnectionId connection)
+{
+    std::shared_ptr<Connection> client;
+    {
+        std::lock_guard<std::mutex> lock(connectionsMutex);
+        auto it = connections.find(connection);
+        if (it == connections.end())
+            return;
+        client = it->second;
+        connections.erase(it);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(client->outputMutex);
+        client->closed = true;
+        client->output.clear();
+        client->outputDrained.notify_all();
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, client->socket, nullptr);
+        close(client->socket);
+    }
+
+    LOG_INFO("Client " << connection << " disconnected.");
+    onDisconnect(connection);
+}
+
+std::shared_ptr<Reactor::Connection> Reactor::findConnection(ConnectionId connection)
+{
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    auto it = connections.find(connection);
+    return it == connections.end() ? nullptr : it->second;
+}
+
+/**
+ * @brief Writes as much of the output buffer as the socket accepts without
+ * blocking and drops the written prefix.
+ * @return false if the connection is broken.
+ */
+bool Reactor::writePending(Connection &client)
+{
+    size_t written = 0;
+    bool healthy = true;
+    while (written < client.output.size())
+    {
+        ssize_t sent = send(client.socket, client.output.data() + written, client.output.size() - written,
+                            MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent > 0)
+        {
+            written += sent;
+            continue;
+        }
+        if (sent < 0 && errno == EINTR)
+            continue;
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        healthy = false;
+        break;
+    }
+    client.output.erase(0, written);
+    return healthy;
+}
+
+/**
+ * @brief Registers the events the connection currently needs: input unless it
+ * is paused or finished, writability while output is pending or a close is
+ * only waiting for it (not for reserved replies). Skips the system call when nothing changed.
+ */
+void Reactor::updateInterest(Connection &client, ConnectionId connection)
+{
+    uint32_t events = 0;
+    if (!client.paused && !client.peerClosed && !client.closeWhenFlushed)
+        events |= EPOLLIN | EPOLLRDHUP;
+    if (!client.output.empty() || (client.closeWhenFlushed && client.nextDelivered == client.nextTicket))
+        events |= EPOLLOUT;
+    if (events == client.interest || client.closed)
+        return;
+
+    epoll_event event = {};
+    event.events = events;
+    event.data.u64 = connection;
+    if (epoll_ctl(epollFd, EPOLL_CTL_MOD, client.socket, &event) < 0)
+        LOG_WARNING("epoll_ctl: " << std::strerror(errno));
+    client.interest = events;
+}
+
+void Reactor::wake()
+{
+    uint64_t one = 1;
+    if (write(wakeFd, &one, sizeof(one)) < 0)
+        LOG_WARNING("eventfd write: " << std::strerror(errno));
+}
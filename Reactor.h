@@ -0,0 +1,175 @@
+// Reactor.h
+#ifndef REACTOR_H
+#define REACTOR_H
+
+#include <map>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+#include <thread>
+#include <functional>
+#include <atomic>
+#include <cstdint>
+#include "LineFramer.h"
+#include "BulkProtocol.h"
+
+// Identifies one client connection for its whole lifetime. Unlike the socket
+// descriptor it is never reused, so a late reply can never reach a newer client.
+typedef uint64_t ConnectionId;
+
+/**
+ * @brief Single-threaded epoll event loop that owns the listening socket and
+ * every client socket.
+ *
+ * All sockets are non-blocking. The reactor thread accepts connections, reads
+ * whatever arrives, splits it into lines and hands each complete line to the
+ * input handler; it never blocks on a single client, so thousands of mostly
+ * idle sessions cost one thread. Long-running work is expected to be handed
+ * off to other threads by the handler.
+ *
+ * A client may pipeline any number of lines in one write. They are handled in
+ * order; a handler that starts work whose result must come first calls
+ * pauseInput(), and the remaining lines wait (and the socket is not read, so
+ * TCP flow control holds the client back) until resumeInput().
+ *
+ * A command that starts with BULK_MAGIC, sent while the bulk gate accepts
+ * uploads from the connection, is a binary bulk upload instead of a line (see
+ * BulkProtocol.h). Its records are received straight into one array, without
+ * passing through the line buffer, and handed to the bulk handler as a whole.
+ *
+ * Replies leave in the order they were reserved. A handler that hands a
+ * request to another thread and resumes input before the reply exists
+ * reserves its place with reserveReply() and fills it in later with
+ * sendReply(); anything sent to the client in between waits behind it.
+ *
+ * A long reply can be streamed: sendReplyPart() sends its text piece by piece
+ * in the reserved place and sendReply() sends the last piece. The streaming
+ * thread waits while too much of it is unwritten, so a slow client holds the
+ * stream back instead of growing the output buffer.
+ *
+ * sendToClient() and closeClient() may be called from any thread. Output is
+ * kept in the connection's buffer; sends from other threads write it right
+ * away, sends from the reactor thread are collected and written once per
+ * event loop iteration, so the replies to a batch of pipelined lines leave in
+ * as few writes as possible. Whatever the socket does not take is flushed when
+ * epoll reports it writable again.
+ */
+class Reactor
+{
+public:
+    typedef std::function<void(ConnectionId)> ConnectHandler;
+    typedef std::function<void(ConnectionId, const std::string &)> InputHandler;
+    typedef std::function<void(ConnectionId)> DisconnectHandler;
+    typedef std::function<bool(ConnectionId)> BulkGate; // Whether the connection's next command may be an upload
+    typedef std::function<void(ConnectionId, const BulkHeader &, std::vector<BulkEdge> &&)> BulkHandler;
+
+    // Longest accepted input line; a client that sends a longer one is disconnected
+    static const size_t MAX_LINE_LENGTH = 4096;
+    // Unwritten output above which sendReplyPart() waits for the client to catch up
+    static const size_t MAX_STREAM_BACKLOG = 1024 * 1024;
+    // Records the array of a bulk upload first grows by; it grows with the data, never ahead of it
+    static const size_t BULK_GROWTH_RECORDS = 64 * 1024;
+
+    // Bulk uploads above maxBulkEdges edges (at most BULK_MAX_EDGES) are refused
+    Reactor(int listenSocket, ConnectHandler onConnect, InputHandler onInput, BulkGate acceptsBulk,
+            BulkHandler onBulk, DisconnectHandler onDisconnect, int64_t maxBulkEdges = BULK_MAX_EDGES);
+    ~Reactor();
+
+    void run(); // Event loop; returns after stop()
+    void stop();
+
+    // Thread-safe. Data for a connection that is already gone is dropped.
+    void sendToClient(ConnectionId connection, const std::string &data);
+    // Thread-safe. Reserves the next place in the connection's reply order.
+    uint64_t reserveReply(ConnectionId connection);
+    // Thread-safe. Fills in a reserved place; it is written once all earlier ones are.
+    void sendReply(ConnectionId connection, uint64_t ticket, const std::string &data);
+    // Any thread but the reactor's. Adds to a reserved place without completing it, then waits until
+    // the backlog, including parts held for this place, is below MAX_STREAM_BACKLOG; false once the
+    // connection is gone.
+    bool sendReplyPart(ConnectionId connection, uint64_t ticket, const std::string &data);
+    // Thread-safe. Closes the connection once its pending output is flushed.
+    void closeClient(ConnectionId connection);
+
+    // Reactor thread only (i.e. from the input handler): hold back further lines
+    void pauseInput(ConnectionId connection);
+    // Thread-safe: continue with the held-back lines, in order
+    void resumeInput(ConnectionId connection);
+
+private:
+    // A place in the reply order that was filled in, or partly filled in, before the earlier ones
+    struct HeldReply
+    {
+        std::string data;
+        bool complete = false; // sendReply() was called; false while sendReplyPart() adds to it
+    };
+
+    struct Connection
+    {
+        int socket;
+        LineFramer framer;       // Reactor thread only
+        bool receivingBulk;      // Reactor thread only, like the three fields below
+        BulkHeader bulkHeader;
+        std::vector<BulkEdge> bulkEdges; // Grown as the records arrive
+        size_t bulkReceived;     // Bytes of bulkEdges filled in so far
+        std::mutex outputMutex;  // Guards everything below
+        std::string output;      // Bytes accepted by sendToClient() but not yet written
+        uint64_t nextTicket;     // Next place in the reply order to hand out
+        uint64_t nextDelivered;  // Place in the reply order whose data goes to 'output' next
+        std::map<uint64_t, HeldReply> heldReplies; // Places waiting for earlier ones
+        std::condition_variable outputDrained;     // Some output was written, or the connection closed
+        uint32_t interest;       // Events currently registered with epoll
+        bool paused;             // Between pauseInput() and resumeInput()
+        bool peerClosed;         // The client shut down its side; close once paused input is done
+        bool closeWhenFlushed;
+        bool closed;
+        bool flushQueued;        // Listed in deferredFlushes
+
+        explicit Connection(int socket)
+            : socket(socket), framer(MAX_LINE_LENGTH), receivingBulk(false), bulkHeader(), bulkReceived(0),
+              nextTicket(0), nextDelivered(0), interest(0), paused(false), peerClosed(false), closeWhenFlushed(false), closed(false),
+              flushQueued(false) {}
+    };
+
+    void acceptConnections();
+    void readFromClient(ConnectionId connection, const std::shared_ptr<Connection> &client);
+    bool dispatchLines(ConnectionId connection, const std::shared_ptr<Connection> &client);
+    bool beginBulk(ConnectionId connection, const std::shared_ptr<Connection> &client);
+    bool growBulk(ConnectionId connection, const std::shared_ptr<Connection> &client, size_t bytes);
+    void receiveBulk(ConnectionId connection, const std::shared_ptr<Connection> &client, size_t bytes);
+    void resumePaused();
+    void flushOutput(ConnectionId connection, const std::shared_ptr<Connection> &client);
+    void flushDeferred();
+    void closeConnection(ConnectionId connection);
+    std::shared_ptr<Connection> findConnection(ConnectionId connection);
+    void deliver(ConnectionId connection, const std::shared_ptr<Connection> &client, uint64_t ticket,
+                 const std::string &data, bool complete);
+    bool writePending(Connection &client); // Called with outputMutex held; false on a socket error
+    void updateInterest(Connection &client, ConnectionId connection); // Called with outputMutex held
+    void wake();
+
+    int listenSocket;
+    int epollFd;
+    int wakeFd; // eventfd that interrupts epoll_wait for stop() and resumeInput()
+    ConnectHandler onConnect;
+    InputHandler onInput;
+    BulkGate acceptsBulk;
+    BulkHandler onBulk;
+    DisconnectHandler onDisconnect;
+    int64_t maxBulkEdges;
+    std::atomic<bool> stopping;
+    std::thread::id reactorThread;
+
+    std::mutex connectionsMutex; // Guards connections and nextConnection
+    std::map<ConnectionId, std::shared_ptr<Connection>> connections;
+    ConnectionId nextConnection;
+
+    std::mutex resumeMutex;
+    std::vector<ConnectionId> resumed; // Passed to resumeInput(), not yet handled by the reactor thread
+
+    std::vector<ConnectionId> deferredFlushes; // Reactor thread only
+};
+
+#endif // REACTOR_H
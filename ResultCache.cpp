@@ -0,0 +1,57 @@
+// ResultCache.cpp
+#include "ResultCache.h"
+
+ResultCache::ResultCache(size_t capacity) : capacity(capacity) {}
+
+bool ResultCache::lookupMST(uint64_t version, const std::string &algorithm, MSTResult &result)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = mstResults.find(Key(version, algorithm));
+    if (it == mstResults.end())
+        return false;
+    result = it->second;
+    return true;
+}
+
+void ResultCache::storeMST(uint64_t version, const std::string &algorithm, const MSTResult &result)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Key key(version, algorithm);
+    if (!mstResults.insert(std::make_pair(key, result)).second)
+        return; // Another thread computed the same result first
+    mstOrder.push_back(key);
+    if (mstOrder.size() > capacity)
+    {
+        mstResults.erase(mstOrder.front());
+        mstOrder.pop_front();
+    }
+}
+
+bool ResultCache::lookupAverageDistance(uint64_t version, bool requireExact, AverageDistanceEstimate &averageDistance)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = averageDistances.find(version);
+    if (it == averageDistances.end() || (requireExact && !it->second.exact))
+        return false;
+    averageDistance = it->second;
+    return true;
+}
+
+void ResultCache::storeAverageDistance(uint64_t version, const AverageDistanceEstimate &averageDistance)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto inserted = averageDistances.insert(std::make_pair(version, averageDistance));
+    if (!inserted.second)
+    {
+        // An exact value replaces an estimate, never the other way round
+        if (averageDistance.exact && !inserted.first->second.exact)
+            inserted.first->second = averageDistance;
+        return;
+    }
+    averageOrder.push_back(version);
+    if (averageOrder.size() > capacity)
+    {
+        averageDistances.erase(averageOrder.front());
+        averageOrder.pop_front();
+    }
+}
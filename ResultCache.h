@@ -0,0 +1,73 @@
+// ResultCache.h
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include <string>
+#include <map>
+#include <deque>
+#include <vector>
+#include <utility>
+#include <mutex>
+#include <cstdint>
+#include "Measurements.h"
+
+// The tree of one connected component in a minimum spanning forest result
+struct ComponentResult
+{
+    int firstVertex = 0; // Smallest vertex of the component
+    int vertices = 0;
+    double totalWeight = 0.0;
+    double longestDistance = 0.0;
+    double shortestDistance = 0.0;
+    double averageTreeDistance = 0.0;
+};
+
+// Everything a "Compute MST" response reports about one (graph version, algorithm) pair
+struct MSTResult
+{
+    double totalWeight = 0.0;
+    double longestDistance = 0.0;
+    double shortestDistance = 0.0;
+    double averageTreeDistance = 0.0;
+    AverageDistanceEstimate averageDistance; // Graph-wide; filled in per request (exact or sampled)
+    std::string computationLog; // Summary of the steps, empty unless the computation was traced
+    std::string kernelName;     // The algorithm that ran, which for "Auto" is the one it selected
+    int vertexCount = 0;        // Of the graph
+    size_t edgeCount = 0;       // Of the tree; fewer than vertexCount - 1 if the graph is disconnected
+    bool spanningForest = false;             // Computed per connected component
+    std::vector<ComponentResult> components; // Spanning forest only, in the order of their smallest vertex
+};
+
+/**
+ * @brief Thread-safe cache of computation results keyed by graph version.
+ *
+ * MST results are keyed by (graph version, algorithm), since different
+ * algorithms may return different trees of equal weight. The average distance
+ * depends only on the graph, so it is keyed by version alone and shared by all
+ * algorithms; an exact value also answers requests for an approximate one. Version numbers are never reused (see Graph::getVersion()), so
+ * stale entries can never be hit; the oldest ones are evicted once the cache
+ * holds more than its capacity.
+ */
+class ResultCache
+{
+public:
+    explicit ResultCache(size_t capacity = 64);
+
+    bool lookupMST(uint64_t version, const std::string &algorithm, MSTResult &result);
+    void storeMST(uint64_t version, const std::string &algorithm, const MSTResult &result);
+
+    bool lookupAverageDistance(uint64_t version, bool requireExact, AverageDistanceEstimate &averageDistance);
+    void storeAverageDistance(uint64_t version, const AverageDistanceEstimate &averageDistance);
+
+private:
+    typedef std::pair<uint64_t, std::string> Key;
+
+    size_t capacity;
+    std::mutex mutex;
+    std::map<Key, MSTResult> mstResults;
+    std::deque<Key> mstOrder; // Insertion order, for eviction
+    std::map<uint64_t, AverageDistanceEstimate> averageDistances;
+    std::deque<uint64_t> averageOrder;
+};
+
+#endif // RESULTCACHE_H
@@ -1,6 +1,5 @@
 // Server.cpp
 
-#include <iostream>
 #include <sstream>
 #include <string>
 #include <pthread.h>
@@ -11,272 +10,1044 @@
 #include <thread>
 #include <csignal> // For signal handling
 #include <atomic>  // For atomic flags
+#include <memory>
+#include <map>
+#include <stdexcept>
+#include <chrono>
+#include <limits>
 
 #include "Server.h"
 #include "Graph.h"
 #include "MSTFactory.h"
 #include "Measurements.h"
-#include "ActiveObject.h"
+#include "PipelineStage.h"
 #include "ThreadPool.h"
+#include "Reactor.h"
+#include "DynamicMST.h"
+#include "GraphStore.h"
+#include "GraphFile.h"
+#include "Logger.h"
+#include "ResultCache.h"
+#include "TreeMetrics.h"
+#include "SpanningForest.h"
 
 using namespace std;
 
-// Global graph object and mutex
-Graph *g = nullptr;
-pthread_mutex_t graphMutex = PTHREAD_MUTEX_INITIALIZER;
+// Named graphs of all clients. Each has its own writer lock, published
+// snapshots and maintained MST, so clients working on different graphs never
+// contend; computations read the snapshots without any lock.
+GraphStore graphStore;
+
+// Results of earlier computations, keyed by graph version
+ResultCache resultCache;
+
+// Startup configuration, filled in by main() from the command line
+ServerConfig serverConfig;
+
+// Dialogue state of every connected client; only touched on the reactor thread
+static map<ConnectionId, ClientSession> sessions;
 
 // Global variables for threading models
+extern Reactor *reactor;
 extern ThreadPool threadPool;
-extern ActiveObject *stage1Pipeline;
-extern ActiveObject *stage2Pipeline;
-extern ActiveObject *stage3Pipeline;
-extern ActiveObject *stage4Pipeline;
+extern PipelineStage *stage1Pipeline;
+extern PipelineStage *stage2Pipeline;
+extern PipelineStage *stage3Pipeline;
+extern PipelineStage *stage4Pipeline;
+
+// Main menu, sent on connect and after every completed command
+static const char *const mainMenu = "Please select an option:\n"
+                                    "1) Create a new graph\n"
+                                    "2) Add an edge\n"
+                                    "3) Remove an edge\n"
+                                    "4) Compute MST\n"
+                                    "5) Exit\n"
+                                    "6) Select a graph by name\n"
+                                    "7) Save the graph to a file\n"
+                                    "8) Open a graph file (memory-mapped, read-only until edited)\n"
+                                    "9) Set the computation trace of MST requests\n"
+                                    "10) Set the scope of MST requests (spanning tree or spanning forest)\n"
+                                    "Enter your choice: \n";
+
+// Algorithm selection prompt (state 6); the choice numbers map to algorithmChoices
+static const char *const algorithmMenu = "Select the algorithm:\n"
+                                         "1) Prim\n"
+                                         "2) Kruskal\n"
+                                         "3) Boruvka (parallel)\n"
+                                         "4) Prim (indexed 4-ary heap)\n"
+                                         "5) Filter-Kruskal (parallel)\n"
+                                         "6) Prim (dense graphs, key array with SIMD scan)\n"
+                                         "7) Maintained MST (updated incrementally across edits)\n"
+                                         "8) Auto (picks one of 1-6 for the graph, learning from their runtimes)\n"
+                                         "Enter your choice: ";
+static const char *const algorithmChoices[] = {"Prim", "Kruskal", "Boruvka", "PrimHeap", "FilterKruskal", "DensePrim",
+                                               "Maintained", "Auto"};
+static const int numAlgorithmChoices = sizeof(algorithmChoices) / sizeof(algorithmChoices[0]);
+
+// Trace level prompt (state 12)
+static const char *const traceMenu = "Select the computation trace of MST requests:\n"
+                                     "1) Off\n"
+                                     "2) Summary (phases and step counts)\n"
+                                     "3) Full (every step, streamed before the result)\n"
+                                     "Enter your choice: ";
 
-// Function prototypes
-void sendMenu(int clientSocket);
-void processClientInput(int clientSocket, const string &input);
+// MST scope prompt (state 13)
+static const char *const scopeMenu = "Select the scope of MST requests:\n"
+                                     "1) Spanning tree (one tree for the whole graph)\n"
+                                     "2) Spanning forest (one tree per connected component, reported per component)\n"
+                                     "Enter your choice: ";
+
+// Components listed one by one in a spanning forest result; the rest are summed up in one line
+static const size_t MAX_LISTED_COMPONENTS = 20;
+
+// Average distance mode prompt (state 8); the Auto threshold comes from serverConfig
+static string averageModeMenu()
+{
+    return "Select the average distance computation:\n"
+           "1) Exact (Dijkstra from every vertex)\n"
+           "2) Approximate (sampled sources, 95% confidence interval)\n"
+           "3) Auto (approximate above " +
+           to_string(serverConfig.approximateAboveVertices) + " vertices)\n"
+           "Enter your choice: ";
+}
 
 // Function definitions
 
+// Version of the graph's current state; called with entry.mutex held
+static uint64_t graphVersion(const GraphEntry &entry)
+{
+    return entry.graph ? entry.graph->getVersion() : entry.mapped->getVersion();
+}
+
+// Publishes the snapshot of the graph's current version, building it if needed; called with entry.mutex held
+static shared_ptr<const CSRGraph> publishSnapshot(GraphEntry &entry)
+{
+    shared_ptr<const CSRGraph> csr = entry.graph ? entry.graph->getCSR() : entry.mapped;
+    entry.versions.publish(csr);
+    return csr;
+}
+
+/**
+ * @brief Returns the snapshot of the current version of a graph for a computation.
+ *
+ * Lock-free unless the graph was edited since the last snapshot was taken; the
+ * first reader of a new version then builds its CSR under the graph's lock,
+ * which takes time linear in the graph size but never waits for a computation.
+ */
+static shared_ptr<const CSRGraph> takeSnapshot(GraphEntry &entry)
+{
+    shared_ptr<const CSRGraph> csr = entry.versions.current();
+    if (csr)
+        return csr;
+    pthread_mutex_lock(&entry.mutex);
+    csr = publishSnapshot(entry);
+    pthread_mutex_unlock(&entry.mutex);
+    return csr;
+}
+
+// Evicts idle graphs once the store is over its memory budget
+static void evictIdleGraphs()
+{
+    for (const string &name : graphStore.evictIdle(serverConfig.graphMemoryBudget))
+        LOG_INFO("Evicted idle graph '" << name << "' to stay within the memory budget.");
+}
+
+/**
+ * @brief Returns the maintained MST, seeding it the first time.
+ * @param csr Replaced by the snapshot of the version the returned MST belongs to.
+ *
+ * The maintained MST follows every edit, so it is read under the graph's
+ * lock, together with the snapshot of the same version. Seeding walks every edge and
+ * is done outside the lock; if the graph was edited meanwhile the seed is
+ * stale and is built again from the newer version.
+ */
+static vector<Edge> maintainedMSTEdges(GraphEntry &entry, shared_ptr<const CSRGraph> &csr, ComputationTrace &trace)
+{
+    bool seededHere = false;
+    pthread_mutex_lock(&entry.mutex);
+    while (!entry.maintainedMST)
+    {
+        csr = publishSnapshot(entry);
+        pthread_mutex_unlock(&entry.mutex);
+        unique_ptr<DynamicMST> seed(new DynamicMST(*csr));
+        pthread_mutex_lock(&entry.mutex);
+        if (!entry.maintainedMST && graphVersion(entry) == csr->getVersion())
+        {
+            entry.maintainedMST = seed.release();
+            seededHere = true;
+        }
+    }
+    if (seededHere)
+    {
+        trace.note("Seeded the maintained MST from ", csr->getNumEdges(), " edges.");
+    }
+    else
+    {
+        trace.note("Served the maintained MST (", entry.maintainedMST->getEditCount(),
+                   " edits applied incrementally since seeding).");
+    }
+    csr = publishSnapshot(entry);
+    vector<Edge> mstEdges = entry.maintainedMST->getMSTEdges();
+    pthread_mutex_unlock(&entry.mutex);
+    return mstEdges;
+}
+
+/**
+ * @brief Computes the MST of the given snapshot with the named algorithm.
+ *
+ * "Maintained" does not run an algorithm: it returns the MST that is updated
+ * on every addEdge/removeEdge (see maintainedMSTEdges()), and may move 'csr'
+ * to a newer version. Every other name goes through MSTFactory and runs on the
+ * snapshot without any lock.
+ *
+ * A spanning forest request also finds the connected components of the
+ * snapshot, for the per-component measurements. The maintained MST already
+ * is a spanning forest; every other algorithm runs once per component (see
+ * computeSpanningForest()).
+ */
+static vector<Edge> runMSTAlgorithm(GraphEntry &entry, const string &algorithmName, shared_ptr<const CSRGraph> &csr,
+                                    bool spanningForest, GraphComponents &components, ComputationTrace &trace,
+                                    string &kernelName)
+{
+    kernelName = algorithmName;
+    if (algorithmName == "Maintained")
+    {
+        vector<Edge> mstEdges = maintainedMSTEdges(entry, csr, trace);
+        if (spanningForest)
+            components = findComponents(*csr);
+        return mstEdges;
+    }
+    if (spanningForest)
+    {
+        components = findComponents(*csr);
+        return computeSpanningForest(*csr, components, algorithmName, trace, kernelName);
+    }
+
+    unique_ptr<MSTAlgorithm> mstAlgorithm(MSTFactory::createAlgorithm(algorithmName));
+    vector<Edge> mstEdges = mstAlgorithm->computeMST(*csr, trace);
+    kernelName = mstAlgorithm->getName();
+    return mstEdges;
+}
+
+// Streams a full trace into the request's place in the client's reply order, ahead of the result block
+class ReplyTraceSink : public TraceSink
+{
+public:
+    ReplyTraceSink(ConnectionId connection, uint64_t replyTicket) : connection(connection), replyTicket(replyTicket) {}
+
+    bool write(const string &chunk) override { return reactor->sendReplyPart(connection, replyTicket, chunk); }
+
+private:
+    ConnectionId connection;
+    uint64_t replyTicket;
+};
+
+/**
+ * @brief Computes the MST of the snapshot and reports the steps at the level
+ * the request asked for.
+ *
+ * A full trace is streamed to the client while the algorithm runs, between a
+ * header and an end line; a client that reads slowly holds the computation
+ * back rather than making the server buffer the trace. The summary goes into
+ * the result block.
+ */
+static vector<Edge> computeTracedMST(ConnectionId connection, uint64_t replyTicket, GraphEntry &entry,
+                                     const string &algorithmName, shared_ptr<const CSRGraph> &csr,
+                                     TraceLevel traceLevel, bool spanningForest, GraphComponents &components,
+                                     MSTResult &mstResult)
+{
+    ReplyTraceSink sink(connection, replyTicket);
+    ComputationTrace trace(traceLevel, &sink);
+    if (traceLevel == TraceLevel::Full)
+    {
+        sink.write("\n==== Computation Trace: " + algorithmName + (spanningForest ? " (spanning forest)" : "") +
+                   " on graph '" + entry.name + "' ====\n# One step per line: <event> <src> <dest> <weight>\n");
+    }
+
+    vector<Edge> mstEdges = runMSTAlgorithm(entry, algorithmName, csr, spanningForest, components, trace,
+                                            mstResult.kernelName);
+
+    mstResult.computationLog = trace.getSummary();
+    if (traceLevel == TraceLevel::Full)
+    {
+        trace.finish();
+        sink.write("==== End of Computation Trace (" + to_string(trace.getEventCount()) + " steps) ====\n");
+        mstResult.computationLog += "(Every step is in the trace above.)\n";
+    }
+    return mstEdges;
+}
+
+// Spanning tree and spanning forest results of the same algorithm are cached apart
+static string resultCacheKey(const string &algorithmName, bool spanningForest)
+{
+    return spanningForest ? algorithmName + " (spanning forest)" : algorithmName;
+}
+
+/**
+ * @brief Looks up the cached MST result for this request.
+ *
+ * A full trace can only come from a run, and a summary only from a cached
+ * result that was computed with one; an untraced request takes any cached
+ * result and drops its summary.
+ */
+static bool lookupMSTResult(uint64_t version, const string &algorithmName, bool spanningForest, TraceLevel traceLevel,
+                            MSTResult &mstResult)
+{
+    if (traceLevel == TraceLevel::Full)
+        return false;
+    MSTResult cached;
+    if (!resultCache.lookupMST(version, resultCacheKey(algorithmName, spanningForest), cached))
+        return false;
+    if (traceLevel == TraceLevel::Summary && cached.computationLog.empty())
+        return false;
+    if (traceLevel == TraceLevel::Off)
+        cached.computationLog.clear();
+    mstResult = cached;
+    return true;
+}
+
+/**
+ * @brief Lists the trees of a spanning forest, largest first. Isolated
+ * vertices are only counted, and past MAX_LISTED_COMPONENTS trees the rest
+ * are summed up in one line.
+ */
+static string formatComponents(const vector<ComponentResult> &components)
+{
+    vector<const ComponentResult *> trees;
+    for (const ComponentResult &component : components)
+    {
+        if (component.vertices > 1)
+            trees.push_back(&component);
+    }
+    stable_sort(trees.begin(), trees.end(), [](const ComponentResult *a, const ComponentResult *b)
+                { return a->vertices > b->vertices; });
+
+    stringstream listing;
+    listing << "\nSpanning Forest: " << components.size() << " component(s), "
+            << components.size() - trees.size() << " of them isolated vertices\n";
+    for (size_t k = 0; k < trees.size() && k < MAX_LISTED_COMPONENTS; ++k)
+    {
+        const ComponentResult &tree = *trees[k];
+        listing << "Component of vertex " << tree.firstVertex << ": " << tree.vertices << " vertices, weight "
+                << tree.totalWeight << ", longest distance " << tree.longestDistance << ", shortest distance "
+                << tree.shortestDistance << ", average distance " << tree.averageTreeDistance << "\n";
+    }
+    if (trees.size() > MAX_LISTED_COMPONENTS)
+    {
+        double weight = 0.0;
+        for (size_t k = MAX_LISTED_COMPONENTS; k < trees.size(); ++k)
+            weight += trees[k]->totalWeight;
+        listing << "... and " << trees.size() - MAX_LISTED_COMPONENTS << " more with at most "
+                << trees[MAX_LISTED_COMPONENTS]->vertices << " vertices each, weight " << weight << " in total\n";
+    }
+    return listing.str();
+}
+
+/**
+ * @brief Builds the result block sent to the client, followed by the main menu.
+ * @param graphName The graph the result belongs to.
+ * @param algorithmName The algorithm the result was computed with.
+ * @param modelDescription How the result was computed (threading model).
+ * @param mstResult The measurements and the summary of the computation steps, if traced.
+ * @param version The graph version the result belongs to.
+ * @param fromCache Whether the MST part of the result was served from the result cache.
+ * @param statistics Optional server statistics printed after the computation steps.
+ */
+static string formatResult(const string &graphName, const string &algorithmName, const string &modelDescription,
+                           const MSTResult &mstResult, uint64_t version, bool fromCache,
+                           const string &statistics = "")
+{
+    const AverageDistanceEstimate &average = mstResult.averageDistance;
+
+    stringstream result;
+    result << "\n==== Computation Result ====\n";
+    result << "Computed using " << algorithmName << " algorithm";
+    if (!mstResult.kernelName.empty() && mstResult.kernelName != algorithmName)
+        result << " (selected " << mstResult.kernelName << ")";
+    result << " with " << modelDescription << " on graph '" << graphName << "':\n";
+    if (fromCache)
+        result << "(Served from the result cache for graph version " << version << ")\n";
+    result << "Total Weight of MST: " << mstResult.totalWeight << "\n";
+    result << "Longest Distance in MST: " << mstResult.longestDistance << "\n";
+    result << "Shortest Distance in MST: " << mstResult.shortestDistance << "\n";
+    result << "Average Distance in MST: " << mstResult.averageTreeDistance << "\n";
+    if (mstResult.spanningForest)
+    {
+        result << formatComponents(mstResult.components);
+    }
+    else if (mstResult.edgeCount + 1 < static_cast<size_t>(mstResult.vertexCount))
+    {
+        result << "Note: the graph is disconnected; the tree has " << mstResult.edgeCount << " of the "
+               << mstResult.vertexCount - 1 << " edges of a spanning tree. Set the scope to spanning forest "
+               << "(option 10) for a tree per component.\n";
+    }
+    if (average.exact)
+    {
+        result << "Average Distance in Graph: " << average.average << " (exact)\n";
+    }
+    else if (average.marginOfError < std::numeric_limits<double>::infinity())
+    {
+        result << "Average Distance in Graph: " << average.average << " +/- " << average.marginOfError
+               << " (approximate, 95% confidence, " << average.sourcesUsed << " sampled sources)\n";
+    }
+    else
+    {
+        result << "Average Distance in Graph: " << average.average << " (approximate, time budget ran out after "
+               << average.sourcesUsed << " sampled sources, no confidence interval)\n";
+    }
+    if (!mstResult.computationLog.empty())
+    {
+        result << "\nComputation Steps:\n"
+               << mstResult.computationLog;
+    }
+    result << statistics;
+    result << "============================\n\n";
+    result << mainMenu;
+    return result.str();
+}
+
+/**
+ * @brief Fills in the measurements of the MST itself.
+ *
+ * The distances inside the MST come from linear-time tree metrics; each
+ * worker thread keeps its own TreeMetrics so the buffers are reused across
+ * requests. A spanning forest (non-empty 'components') is also measured per
+ * component.
+ */
+static void measureMST(const CSRGraph &csr, const vector<Edge> &mstEdges, const GraphComponents &components,
+                       bool spanningForest, MSTResult &mstResult)
+{
+    static thread_local TreeMetrics treeMetrics;
+
+    mstResult.vertexCount = csr.getNumVertices();
+    mstResult.edgeCount = mstEdges.size();
+    mstResult.spanningForest = spanningForest;
+    if (spanningForest)
+    {
+        vector<TreeDistances> perTree = treeMetrics.computePerTree(csr.getNumVertices(), mstEdges,
+                                                                   components.componentOf, components.count());
+        mstResult.components.assign(components.count(), ComponentResult());
+        for (int u = csr.getNumVertices(); u-- > 0;)
+            mstResult.components[components.componentOf[u]].firstVertex = u;
+        for (const Edge &edge : mstEdges)
+            mstResult.components[components.componentOf[edge.src]].totalWeight += edge.weight;
+        for (int c = 0; c < components.count(); ++c)
+        {
+            ComponentResult &component = mstResult.components[c];
+            component.vertices = components.sizes[c];
+            component.longestDistance = perTree[c].longestDistance;
+            component.shortestDistance = perTree[c].shortestDistance;
+            component.averageTreeDistance = perTree[c].pairCount == 0 ? 0.0 : perTree[c].sumOfDistances / static_cast<double>(perTree[c].pairCount);
+        }
+    }
+
+    // Calculate the total weight of the MST
+    mstResult.totalWeight = calculateTotalWeight(mstEdges);
+
+    // Calculate the longest, shortest and average distances in the MST
+    TreeDistances distances = treeMetrics.compute(csr.getNumVertices(), mstEdges);
+    mstResult.longestDistance = distances.longestDistance;
+    mstResult.shortestDistance = distances.shortestDistance;
+    mstResult.averageTreeDistance = distances.pairCount == 0 ? 0.0 : distances.sumOfDistances / static_cast<double>(distances.pairCount);
+}
+
+// Whether a request in the given mode wants the exact average distance for this graph
+static bool wantsExactAverage(const CSRGraph &csr, AverageDistanceMode mode)
+{
+    if (mode == AverageDistanceMode::Auto)
+        return csr.getNumVertices() <= serverConfig.approximateAboveVertices;
+    return mode == AverageDistanceMode::Exact;
+}
+
+/**
+ * @brief Looks up the cached average distance in the graph for this request.
+ * @return false if it still has to be computed with computeAverageDistance().
+ */
+static bool lookupAverageDistance(const CSRGraph &csr, AverageDistanceMode mode, MSTResult &mstResult)
+{
+    return resultCache.lookupAverageDistance(csr.getVersion(), wantsExactAverage(csr, mode), mstResult.averageDistance);
+}
+
+/**
+ * @brief Computes the average distance in the graph, exactly or by sampling
+ * sources, and caches it. It depends only on the graph version, so every
+ * algorithm shares the cached value.
+ */
+static void computeAverageDistance(const CSRGraph &csr, AverageDistanceMode mode, MSTResult &mstResult)
+{
+    if (wantsExactAverage(csr, mode))
+    {
+        AverageDistanceEstimate exact;
+        exact.average = calculateAverageDistance(csr);
+        exact.sourcesUsed = csr.getNumVertices();
+        mstResult.averageDistance = exact;
+    }
+    else
+    {
+        ApproximationSettings settings;
+        settings.targetRelativeError = serverConfig.approximateTargetError;
+        settings.timeBudgetSeconds = serverConfig.approximateTimeBudget;
+        settings.seed = static_cast<unsigned>(csr.getVersion());
+        mstResult.averageDistance = estimateAverageDistance(csr, settings);
+    }
+    resultCache.storeAverageDistance(csr.getVersion(), mstResult.averageDistance);
+}
+
+/**
+ * @brief Sends the result of a compute request in the place reserved for it
+ * when the request was read, so results reach each client in request order
+ * even when replicated stages finish them out of order.
+ */
+static void sendComputationResult(ConnectionId connection, uint64_t replyTicket, const string &result)
+{
+    reactor->sendReply(connection, replyTicket, result);
+}
+
+/**
+ * @brief Lets the reactor continue with the lines the client pipelined behind
+ * a compute request, once the request has its graph snapshot and its MST. Later
+ * edits cannot change its result any more, while its measurements and reply
+ * may still be on their way.
+ */
+static void releaseClientInput(ConnectionId connection)
+{
+    reactor->resumeInput(connection);
+}
+
+// Queue depth and service time of every pipeline stage, for the result block
+static string pipelineStatistics()
+{
+    PipelineStage *stages[] = {stage1Pipeline, stage2Pipeline, stage3Pipeline, stage4Pipeline};
+    stringstream statistics;
+    statistics << "\nPipeline Stages:\n";
+    for (int i = 0; i < 4; ++i)
+    {
+        StageStatistics stage = stages[i]->getStatistics();
+        statistics << "Stage " << i + 1 << ": " << stage.replicas << " replica(s), queue depth " << stage.queueDepth
+                   << ", " << stage.completedTasks << " tasks, mean service time "
+                   << stage.meanServiceMilliseconds << " ms\n";
+    }
+    return statistics.str();
+}
+
+// State of one Pipeline request; allocated once and moved from stage to stage
+struct PipelineJob
+{
+    ConnectionId connection;
+    uint64_t replyTicket; // Place of the result in the client's reply order
+    shared_ptr<GraphEntry> graph;
+    string algorithmName;
+    AverageDistanceMode averageMode;
+    TraceLevel traceLevel;
+    bool spanningForest;
+    shared_ptr<const CSRGraph> csr; // Snapshot taken in stage 2
+    uint64_t version = 0;
+    bool fromCache = false;
+    vector<Edge> mstEdges;
+    GraphComponents components; // Spanning forest only
+    MSTResult mstResult;
+};
+
 /**
  * @brief Computes MST using the Pipeline threading model.
- * @param clientSocket The client's socket descriptor.
+ * @param connection The client connection the result is sent to.
+ * @param replyTicket The place reserved for the result in the client's reply order.
+ * @param graph The graph to compute the MST of.
  * @param algorithmName The name of the MST algorithm to use ("Prim" or "Kruskal").
+ * @param averageMode Whether the average distance in the graph is exact or sampled.
+ * @param traceLevel How much of the computation is reported (see computeTracedMST()).
+ * @param spanningForest Whether to compute a tree per connected component.
+ *
+ * The request travels through the stages as one PipelineJob owned by a
+ * unique_ptr, so each hand-off moves a pointer: the MST edges and the
+ * computation log are never copied, and the stage tasks fit in a Task's
+ * inline buffer. If the MST result and the average distance are both cached
+ * for the current graph version, stage 2 hands the job straight to the
+ * response stage.
  */
-void computeMSTWithPipeline(int clientSocket, const string &algorithmName)
+void computeMSTWithPipeline(ConnectionId connection, uint64_t replyTicket, const shared_ptr<GraphEntry> &graph,
+                            const string &algorithmName, AverageDistanceMode averageMode, TraceLevel traceLevel,
+                            bool spanningForest)
 {
+    unique_ptr<PipelineJob> job(new PipelineJob());
+    job->connection = connection;
+    job->replyTicket = replyTicket;
+    job->graph = graph;
+    job->algorithmName = algorithmName;
+    job->averageMode = averageMode;
+    job->traceLevel = traceLevel;
+    job->spanningForest = spanningForest;
+
     // Enqueue the initial task to Stage 1
-    stage1Pipeline->enqueue([clientSocket, algorithmName]()
+    stage1Pipeline->enqueue([job = move(job)]() mutable
                             {
-                                // Stage 1: Parsing Stage
-                                cout << "[Pipeline] Stage 1: Parsing command on Thread "
-                                     << this_thread::get_id() << ".\n";
-
-                                // Copy the algorithm name for use in the next stage
-                                string algName = algorithmName;
-
-                                // Pass to Stage 2
-                                stage2Pipeline->enqueue([clientSocket, algName]()
-                                                        {
-                                                            // Stage 2: Computation Stage - Compute MST
-                                                            cout << "[Pipeline] Stage 2: Computing MST using " << algName
-                                                                 << " on Thread " << this_thread::get_id() << ".\n";
-
-                                                            // Lock the mutex to safely access the shared graph object
-                                                            pthread_mutex_lock(&graphMutex);
-
-                                                            // Create the MST algorithm instance based on the provided name
-                                                            auto mstAlgorithm = MSTFactory::createAlgorithm(algName);
-
-                                                            // Compute the Minimum Spanning Tree (MST) and get the computation log
-                                                            auto mstEdges = mstAlgorithm->computeMST(*g);
-                                                            string computationLog = mstAlgorithm->getComputationLog();
-
-                                                            // Unlock the mutex after accessing the graph
-                                                            pthread_mutex_unlock(&graphMutex);
-
-                                                            // Pass to Stage 3 - Measurements
-                                                            stage3Pipeline->enqueue([clientSocket, algName, mstEdges, computationLog]()
-                                                                                    {
-                                                                                        // Stage 3: Measurement Stage
-                                                                                        cout << "[Pipeline] Stage 3: Calculating measurements on Thread "
-                                                                                             << this_thread::get_id() << ".\n";
-
-                                                                                        // Calculate the total weight of the MST
-                                                                                        double totalWeight = calculateTotalWeight(mstEdges);
-
-                                                                                        // Build a graph representation of the MST
-                                                                                        Graph mstGraph = buildMSTGraph(g->getNumVertices(), mstEdges);
-
-                                                                                        // Calculate the longest and shortest distances in the MST
-                                                                                        auto distances = calculateDistancesInMST(mstGraph);
-
-                                                                                        // Calculate the average distance in the original graph
-                                                                                        double averageDistance = calculateAverageDistance(*g);
-
-                                                                                        // Pass to Stage 4 - Response
-                                                                                        stage4Pipeline->enqueue([clientSocket, algName, totalWeight, distances, averageDistance, computationLog]()
-                                                                                                                {
-                                                                                                                    // Stage 4: Response Stage
-                                                                                                                    cout << "[Pipeline] Stage 4: Sending response on Thread "
-                                                                                                                         << this_thread::get_id() << ".\n";
-
-                                                                                                                    // Prepare the result message with separators
-                                                                                                                    stringstream result;
-                                                                                                                    result << "\n==== Computation Result ====\n";
-                                                                                                                    result << "Computed using " << algName << " algorithm with Pipeline pattern:\n";
-                                                                                                                    result << "Total Weight of MST: " << totalWeight << "\n";
-                                                                                                                    result << "Longest Distance in MST: " << distances.first << "\n";
-                                                                                                                    result << "Shortest Distance in MST: " << distances.second << "\n";
-                                                                                                                    result << "Average Distance in Graph: " << averageDistance << "\n";
-                                                                                                                    result << "\nComputation Steps:\n"
-                                                                                                                           << computationLog;
-                                                                                                                    result << "============================\n\n";
-                                                                                                                    result << "Please select an option:\n"
-                                                                                                                              "1) Create a new graph\n"
-                                                                                                                              "2) Add an edge\n"
-                                                                                                                              "3) Remove an edge\n"
-                                                                                                                              "4) Compute MST\n"
-                                                                                                                              "5) Exit\n"
-                                                                                                                              "Enter your choice: \n";
-                                                                                                                    // Send the result to the client
-                                                                                                                    send(clientSocket, result.str().c_str(), result.str().size(), 0);
-
-                                                                                                                    // Send the menu again to the client
-                                                                                                                }); // End of Stage 4
-                                                                                    });                             // End of Stage 3
-                                                        });                                                         // End of Stage 2
-                            });                                                                                     // End of Stage 1
+        // Stage 1: Parsing Stage - the request was parsed by the session; pass it on
+        stage2Pipeline->enqueue([job = move(job)]() mutable
+                                {
+            // Stage 2: Computation Stage - Compute MST
+            // Take the snapshot of the current graph version; this stage and
+            // stage 3 only read it, so edits go on while they run
+            job->csr = takeSnapshot(*job->graph);
+
+            job->fromCache = lookupMSTResult(job->csr->getVersion(), job->algorithmName, job->spanningForest,
+                                             job->traceLevel, job->mstResult);
+            if (!job->fromCache)
+            {
+                // Compute the Minimum Spanning Tree (MST), tracing it as requested
+                job->mstEdges = computeTracedMST(job->connection, job->replyTicket, *job->graph, job->algorithmName,
+                                                 job->csr, job->traceLevel, job->spanningForest, job->components,
+                                                 job->mstResult);
+            }
+            job->version = job->csr->getVersion();
+            releaseClientInput(job->connection);
+
+            if (job->fromCache && lookupAverageDistance(*job->csr, job->averageMode, job->mstResult))
+            {
+                // Nothing to compute or measure; respond right away
+                stage4Pipeline->enqueue([job = move(job)]()
+                                        {
+                    string result = formatResult(job->graph->name, job->algorithmName, "Pipeline pattern", job->mstResult,
+                                                 job->version, true, pipelineStatistics());
+                    sendComputationResult(job->connection, job->replyTicket, result); });
+                return;
+            }
+
+            // Pass to Stage 3 - Measurements
+            stage3Pipeline->enqueue([job = move(job)]() mutable
+                                    {
+                // Stage 3: Measurement Stage
+                if (!job->fromCache)
+                {
+                    measureMST(*job->csr, job->mstEdges, job->components, job->spanningForest, job->mstResult);
+                    resultCache.storeMST(job->version, resultCacheKey(job->algorithmName, job->spanningForest),
+                                         job->mstResult);
+                }
+                if (!lookupAverageDistance(*job->csr, job->averageMode, job->mstResult))
+                    computeAverageDistance(*job->csr, job->averageMode, job->mstResult);
+
+                // Pass to Stage 4 - Response
+                stage4Pipeline->enqueue([job = move(job)]()
+                                        {
+                    // Stage 4: Response Stage - send the result and the menu to the client
+                    string result = formatResult(job->graph->name, job->algorithmName, "Pipeline pattern", job->mstResult,
+                                                 job->version, job->fromCache, pipelineStatistics());
+                    sendComputationResult(job->connection, job->replyTicket, result); }); // End of Stage 4
+            }); // End of Stage 3
+        }); // End of Stage 2
+    }); // End of Stage 1
 }
 
 /**
  * @brief Computes MST using the Leader-Follower threading model with a thread pool.
- * @param clientSocket The client's socket descriptor.
+ * @param connection The client connection the result is sent to.
+ * @param replyTicket The place reserved for the result in the client's reply order.
+ * @param graph The graph to compute the MST of.
  * @param algorithmName The name of the MST algorithm to use ("Prim" or "Kruskal").
+ * @param averageMode Whether the average distance in the graph is exact or sampled.
+ * @param traceLevel How much of the computation is reported (see computeTracedMST()).
+ * @param spanningForest Whether to compute a tree per connected component.
  *
  * This function is a bit tricky, so I'll explain what it does:
  *
  * 1. It takes a client socket and an algorithm name as arguments.
- * 2. It creates an MST algorithm using the provided algorithm name.
- * 3. It locks a mutex (graphMutex) so that only one thread can access the graph at a time.
- * 4. It computes the MST using the selected algorithm and logs the computation steps.
- * 5. It performs some measurements on the MST (total weight, longest and shortest distances, average distance).
- * 6. It prepares a response string that includes the measurements and the computation steps.
- * 7. It sends the response string and the main menu to the client.
- * 8. If an exception is thrown during the computation, it catches it, unlocks the mutex, and sends an error message to the client.
+ * 2. It takes the immutable snapshot of the current graph version, without locking the graph,
+ *    so edits and other computations go on while it runs.
+ * 3. If a result for the snapshot's version and algorithm is cached, it uses that one.
+ * 4. Otherwise it computes the MST using the selected algorithm, tracing its steps as requested.
+ * 5. It performs some measurements on the snapshot and the MST (total weight, longest and
+ *    shortest distances), then stores the result in the cache.
+ * 6. It takes the average distance in the graph from the cache, or computes it (exactly or
+ *    by sampling, depending on averageMode) and caches it.
+ * 7. It prepares a response string that includes the measurements and the summary of the steps, if traced.
+ * 8. It sends the response string and the main menu to the client.
  *
  * To achieve this, it enqueues the computation task to the thread pool, which will execute the task on one of its threads.
  * This allows multiple clients to be handled concurrently.
  */
-void computeMSTWithThreadPool(int clientSocket, const string &algorithmName)
+void computeMSTWithThreadPool(ConnectionId connection, uint64_t replyTicket, const shared_ptr<GraphEntry> &graph,
+                              const string &algorithmName, AverageDistanceMode averageMode, TraceLevel traceLevel,
+                              bool spanningForest)
 {
     // Enqueue the computation task to the thread pool
-    threadPool.enqueueTask([clientSocket, algorithmName]()
+    threadPool.enqueueTask([connection, replyTicket, graph, algorithmName, averageMode, traceLevel, spanningForest]()
                            {
-        cout << "[ThreadPool] Computing MST using " << algorithmName
-             << " on Thread " << this_thread::get_id() << ".\n";
-
-        // Lock the mutex to ensure that only one thread can access the graph at a time
-            // Create an MST algorithm using the provided algorithm name
-            auto mstAlgorithm = MSTFactory::createAlgorithm(algorithmName);
-
-        pthread_mutex_lock(&graphMutex);
-        // Compute MST and log steps
-        auto mstEdges = mstAlgorithm->computeMST(*g);
-        string computationLog = mstAlgorithm->getComputationLog();
-
-        // Perform measurements
-        double totalWeight = calculateTotalWeight(mstEdges);
-        Graph mstGraph = buildMSTGraph(g->getNumVertices(), mstEdges);
-        auto distances = calculateDistancesInMST(mstGraph);
-        double averageDistance = calculateAverageDistance(*g);
-
-        // Unlock the mutex so that other threads can access the graph
-        pthread_mutex_unlock(&graphMutex);
-
-        // Prepare the result with separators
-        stringstream result;
-        result << "\n==== Computation Result ====\n";
-        result << "Computed using " << algorithmName << " algorithm with Leader-Follower Thread Pool:\n";
-        result << "Total Weight of MST: " << totalWeight << "\n";
-        result << "Longest Distance in MST: " << distances.first << "\n";
-        result << "Shortest Distance in MST: " << distances.second << "\n";
-        result << "Average Distance in Graph: " << averageDistance << "\n";
-        result << "\nComputation Steps:\n" << computationLog;
-        result << "============================\n\n";
-        result << "Please select an option:\n"
-                    "1) Create a new graph\n"
-                    "2) Add an edge\n"
-                    "3) Remove an edge\n"
-                    "4) Compute MST\n"
-                    "5) Exit\n"
-                    "Enter your choice: \n";
+        LOG_DEBUG("[ThreadPool] Computing MST using " << algorithmName << " on Thread " << this_thread::get_id()
+                                                      << ".");
+
+        // Take the snapshot of the current graph version; edits made from now
+        // on create new versions and leave this one untouched
+        shared_ptr<const CSRGraph> csr = takeSnapshot(*graph);
+
+        MSTResult mstResult;
+        bool fromCache = lookupMSTResult(csr->getVersion(), algorithmName, spanningForest, traceLevel, mstResult);
+        vector<Edge> mstEdges;
+        GraphComponents components;
+        if (!fromCache)
+        {
+            // Compute MST on the CSR snapshot, tracing it as requested
+            mstEdges = computeTracedMST(connection, replyTicket, *graph, algorithmName, csr, traceLevel,
+                                        spanningForest, components, mstResult);
+        }
+        uint64_t version = csr->getVersion();
+        releaseClientInput(connection);
+
+        if (!fromCache)
+        {
+            // Perform measurements
+            measureMST(*csr, mstEdges, components, spanningForest, mstResult);
+            resultCache.storeMST(version, resultCacheKey(algorithmName, spanningForest), mstResult);
+        }
+        if (!lookupAverageDistance(*csr, averageMode, mstResult))
+            computeAverageDistance(*csr, averageMode, mstResult);
+
         // Send the result to the client
-        send(clientSocket, result.str().c_str(), result.str().size(), 0);
-        cout << "[ThreadPool] Sent computation result to client.\n"; });
+        string result = formatResult(graph->name, algorithmName, "Leader-Follower Thread Pool", mstResult, version,
+                                     fromCache);
+        sendComputationResult(connection, replyTicket, result);
+        LOG_DEBUG("[ThreadPool] Sent computation result to client " << connection << "."); });
 }
 
 /**
- * @brief Handles communication with a connected client.
- * @param arg Pointer to the client's socket descriptor.
- * @return nullptr
+ * @brief Sends the main menu to the client.
+ * @param connection The client connection.
  */
-void *handleClient(void *arg)
+void sendMenu(ConnectionId connection)
 {
-    // Retrieve the socket descriptor from the argument and delete the pointer
-    int clientSocket = *(int *)arg;
-    delete (int *)arg;
+    string menu = mainMenu;
+    reactor->sendToClient(connection, menu);
+}
 
-    // Buffer to store incoming data from the client
-    char buffer[4096];
-    // String to store the line received from the client
-    string line;
+/**
+ * @brief Starts the dialogue with a newly connected client.
+ * @param connection The client connection.
+ */
+void openSession(ConnectionId connection)
+{
+    sessions[connection] = ClientSession();
+    sendMenu(connection);
+}
 
-    // Send the menu
-    sendMenu(clientSocket);
+/**
+ * @brief Forgets the dialogue state of a disconnected client.
+ * @param connection The client connection.
+ */
+void closeSession(ConnectionId connection)
+{
+    sessions.erase(connection);
+    evictIdleGraphs(); // The client's graph may be idle now
+}
+
+/**
+ * @brief Locks the graph the client has selected.
+ * @return The graph's entry with its mutex held, or null (nothing locked) if
+ * the graph has not been created yet.
+ */
+static GraphEntry *lockSelectedGraph(ClientSession &session)
+{
+    if (!session.graph)
+        session.graph = graphStore.find(session.graphName); // Another client may have created it
+    if (!session.graph)
+        return nullptr;
+    pthread_mutex_lock(&session.graph->mutex);
+    if (session.graph->graph || session.graph->mapped)
+        return session.graph.get();
+    pthread_mutex_unlock(&session.graph->mutex);
+    return nullptr;
+}
+
+// After the graph was edited or replaced, with entry.mutex held: retires the old snapshot and recounts the memory
+static void graphChanged(GraphEntry &entry)
+{
+    entry.versions.advance(graphVersion(entry));
+    graphStore.updateMemory(entry);
+}
+
+// Replaces the graph (and whatever file it was mapped from) with a new one; called with entry.mutex held
+static void replaceGraph(GraphEntry &entry, Graph *graph, shared_ptr<const CSRGraph> mapped)
+{
+    delete entry.graph;
+    entry.graph = graph;
+    entry.mapped = move(mapped);
+    delete entry.maintainedMST; // The maintained MST belonged to the old graph
+    entry.maintainedMST = nullptr;
+    graphChanged(entry);
+}
+
+// Whether both endpoints name vertices of the graph; called with entry.mutex held, without copying a mapped graph
+static bool validEdge(const GraphEntry &entry, int src, int dest)
+{
+    int numVertices = entry.graph ? entry.graph->getNumVertices() : entry.mapped->getNumVertices();
+    return src >= 0 && dest >= 0 && src < numVertices && dest < numVertices;
+}
+
+// One edge added to or removed from a graph, vertices numbered from 0
+struct GraphEdit
+{
+    bool remove;
+    int src, dest;
+    double weight;
+};
+
+// Applies an edit to the graph and its maintained MST; called with entry.mutex held and entry.graph editable
+static void applyEdit(GraphEntry &entry, const GraphEdit &edit)
+{
+    if (edit.remove)
+        entry.graph->removeEdge(edit.src, edit.dest); // Remove edge from graph
+    else
+        entry.graph->addEdge(edit.src, edit.dest, edit.weight); // Add edge to graph
+    graphChanged(entry);
+    if (entry.maintainedMST)
+    {
+        // Another client may already have seeded it; update it incrementally
+        if (edit.remove)
+            entry.maintainedMST->removeEdge(edit.src, edit.dest);
+        else
+            entry.maintainedMST->addEdge(edit.src, edit.dest, edit.weight);
+    }
+}
 
-    // Continuously handle client requests until disconnection or error
-    while (true)
+/**
+ * @brief Applies a validated edit to the locked graph entry, unlocks it and
+ * sends 'reply' (the next prompt) to the client.
+ *
+ * A graph opened from a file is read-only, so the first edit copies it into a
+ * Graph (copy-on-write). The copy takes time linear in the graph size, so it is
+ * built on the thread pool from the mapped snapshot, outside the graph's lock,
+ * while the client's further input waits; the lock is only taken again to swap
+ * it in and apply the edit. If the graph was replaced meanwhile the copy is
+ * made again from the new file, or the edit goes to the new graph directly.
+ * Computations that still use the mapped snapshot keep the file mapped until
+ * they finish.
+ */
+static void editGraph(ConnectionId connection, const shared_ptr<GraphEntry> &entry, const GraphEdit &edit,
+                      const string &reply)
+{
+    if (entry->graph)
     {
-        // Receive input from the client into the buffer
-        ssize_t bytesReceived = recv(clientSocket, buffer, sizeof(buffer) - 1, 0);
-        // Check if the client has disconnected or an error occurred
-        if (bytesReceived <= 0)
+        applyEdit(*entry, edit);
+        pthread_mutex_unlock(&entry->mutex);
+        evictIdleGraphs();
+        reactor->sendToClient(connection, reply);
+        return;
+    }
+    pthread_mutex_unlock(&entry->mutex);
+
+    reactor->pauseInput(connection);
+    threadPool.enqueueTask([connection, entry, edit, reply]()
+                           {
+        pthread_mutex_lock(&entry->mutex);
+        while (!entry->graph)
+        {
+            shared_ptr<const CSRGraph> mapped = entry->mapped;
+            pthread_mutex_unlock(&entry->mutex);
+            unique_ptr<Graph> copy(new Graph(*mapped));
+            pthread_mutex_lock(&entry->mutex);
+            if (!entry->graph && entry->mapped == mapped)
+            {
+                entry->graph = copy.release();
+                entry->mapped.reset();
+            }
+        }
+
+        string message;
+        if (validEdge(*entry, edit.src, edit.dest))
+            applyEdit(*entry, edit);
+        else
+            message = "Vertex out of range: the graph was replaced meanwhile, so the edge was not applied.\n";
+        pthread_mutex_unlock(&entry->mutex);
+        evictIdleGraphs();
+
+        reactor->sendToClient(connection, message + reply);
+        reactor->resumeInput(connection); });
+}
+
+/**
+ * @brief Whether the client's next command may be a binary bulk upload.
+ *
+ * Called by the reactor before it reads a command that starts with
+ * BULK_MAGIC as an upload header: only at the main menu, so input at any
+ * prompt is always a line. Stays the same while the upload is received, since
+ * no lines are handled meanwhile.
+ */
+bool acceptsBulkUpload(ConnectionId connection)
+{
+    return sessions[connection].state == 0;
+}
+
+/**
+ * @brief Replaces the graph with the one received in a binary bulk upload.
+ * @param connection The client connection.
+ * @param header The upload header (number of vertices and edges).
+ * @param edges The edge records, vertices numbered from 0 as in option 1.
+ *
+ * Only received at the main menu (see acceptsBulkUpload); the upload
+ * replaces the client's selected graph, creating it if needed. The records
+ * are checked and the new graph is built on the thread pool, outside the
+ * graph's lock, so neither the reactor nor other clients wait for it; the
+ * lock is only taken to swap the graphs. The client's further input waits
+ * until the graph is in place.
+ */
+void processBulkUpload(ConnectionId connection, const BulkHeader &header, vector<BulkEdge> &&edges)
+{
+    ClientSession &session = sessions[connection];
+    reactor->pauseInput(connection);
+    session.graph = graphStore.findOrCreate(session.graphName);
+    shared_ptr<GraphEntry> entry = session.graph;
+    int numVertices = header.numVertices;
+    shared_ptr<vector<BulkEdge>> records = make_shared<vector<BulkEdge>>(move(edges));
+    threadPool.enqueueTask([connection, entry, numVertices, records]()
+                           {
+        string reply;
+        bool valid = true;
+        for (const auto &edge : *records)
+        {
+            if (edge.src < 0 || edge.dest < 0 || edge.src >= numVertices || edge.dest >= numVertices)
+            {
+                valid = false;
+                break;
+            }
+        }
+
+        if (valid)
         {
-            // Inform that the client has disconnected or an error has occurred
-            cout << "Client disconnected or error occurred.\n";
-            // Close the client socket to release resources
-            close(clientSocket);
-            return nullptr;
+            Graph *loaded = new Graph(numVertices);
+            loaded->addEdges(*records);
+            shared_ptr<const CSRGraph> snapshot = loaded->getCSR(); // Built before anyone can see the graph
+
+            pthread_mutex_lock(&entry->mutex);
+            replaceGraph(*entry, loaded, nullptr);
+            entry->versions.publish(snapshot);
+            pthread_mutex_unlock(&entry->mutex);
+            evictIdleGraphs();
+
+            reply = "Loaded graph '" + entry->name + "' with " + to_string(numVertices) + " vertices and " +
+                    to_string(records->size()) + " edges.\n";
         }
+        else
+        {
+            reply = "Invalid binary upload: vertex out of range.\n";
+        }
+
+        reactor->sendToClient(connection, reply + mainMenu);
+        reactor->resumeInput(connection); });
+}
 
-        // Null-terminate the buffer to create a proper C-style string
-        buffer[bytesReceived] = '\0';
-        // Convert the buffer into a C++ string for easier processing
-        line = buffer;
+/**
+ * @brief Resolves a graph file name typed by the client inside serverConfig.graphDirectory.
+ * @return The path on the server, or "" if the name is empty, absolute or has a ".." component.
+ *
+ * Clients are not trusted with the server's file system: they may only name
+ * files in the graph directory and its subdirectories.
+ */
+static string graphFilePath(const string &input)
+{
+    size_t first = input.find_first_not_of(" \t");
+    if (first == string::npos)
+        return "";
+    size_t last = input.find_last_not_of(" \t");
+    string name = input.substr(first, last - first + 1);
+    if (name[0] == '/' || name.find('\0') != string::npos)
+        return "";
 
-        // Process the input received from the client
-        processClientInput(clientSocket, line);
+    stringstream components(name);
+    string component;
+    while (getline(components, component, '/'))
+    {
+        if (component == "..")
+            return "";
     }
+    return serverConfig.graphDirectory + "/" + name;
+}
 
-    // Close the client socket (this line is unreachable due to the infinite loop)
-    close(clientSocket);
-    return nullptr;
+/**
+ * @brief Writes the current version of a graph to a graph file (see GraphFile.h).
+ * @param connection The client connection the reply is sent to.
+ * @param graph The graph to save.
+ * @param path Where to write the file on the server, inside the graph directory (see graphFilePath).
+ *
+ * Runs on the thread pool from the graph's snapshot, so edits go on while the
+ * file is written; the client's further input waits for the reply.
+ */
+static void saveGraphToFile(ConnectionId connection, const shared_ptr<GraphEntry> &graph, const string &path)
+{
+    reactor->pauseInput(connection);
+    threadPool.enqueueTask([connection, graph, path]()
+                           {
+        shared_ptr<const CSRGraph> csr = takeSnapshot(*graph);
+        string reply, error;
+        if (saveGraphFile(*csr, path, error))
+        {
+            reply = "Saved graph '" + graph->name + "' (" + to_string(csr->getNumVertices()) + " vertices, " +
+                    to_string(csr->getNumEdges()) + " edges) to " + path + ".\n";
+        }
+        else
+        {
+            reply = error + "\n";
+        }
+        reactor->sendToClient(connection, reply + mainMenu);
+        reactor->resumeInput(connection); });
 }
 
 /**
- * @brief Sends the main menu to the client.
- * @param clientSocket The client's socket descriptor.
+ * @brief Replaces a graph with a memory-mapped graph file (see GraphFile.h).
+ * @param connection The client connection the reply is sent to.
+ * @param graph The graph to replace.
+ * @param path The file on the server, inside the graph directory (see graphFilePath).
+ *
+ * The file is used in place as the graph's snapshot, read-only; the first
+ * edit copies it into memory. Mapping and validating it runs on the thread
+ * pool, and the client's further input waits for the reply.
  */
-void sendMenu(int clientSocket)
+static void openGraphFromFile(ConnectionId connection, const shared_ptr<GraphEntry> &graph, const string &path)
 {
-    string menu = "Please select an option:\n"
-                  "1) Create a new graph\n"
-                  "2) Add an edge\n"
-                  "3) Remove an edge\n"
-                  "4) Compute MST\n"
-                  "5) Exit\n"
-                  "Enter your choice: \n";
-    send(clientSocket, menu.c_str(), menu.size(), 0);
+    reactor->pauseInput(connection);
+    threadPool.enqueueTask([connection, graph, path]()
+                           {
+        auto start = chrono::steady_clock::now();
+        string reply, error;
+        shared_ptr<const CSRGraph> csr = openGraphFile(path, serverConfig.mapHints, error);
+        if (csr)
+        {
+            pthread_mutex_lock(&graph->mutex);
+            replaceGraph(*graph, nullptr, csr);
+            graph->versions.publish(csr);
+            pthread_mutex_unlock(&graph->mutex);
+            evictIdleGraphs();
+
+            double milliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            reply = "Opened " + path + " as graph '" + graph->name + "' (" + to_string(csr->getNumVertices()) +
+                    " vertices, " + to_string(csr->getNumEdges()) + " edges) in " + to_string(milliseconds) +
+                    " ms.\n";
+        }
+        else
+        {
+            reply = error + "\n";
+        }
+        reactor->sendToClient(connection, reply + mainMenu);
+        reactor->resumeInput(connection); });
 }
 
 /**
- * @brief Processes input received from the client.
- * @param clientSocket The client's socket descriptor.
- * @param input The input received from the client.
+ * @brief Processes one line of input received from the client.
+ * @param connection The client connection.
+ * @param input The line received from the client, without its newline.
+ *
+ * Called on the reactor thread, once per line and in the order the client
+ * sent them, so it must never block for long. A compute request pauses the
+ * connection's input until it has its graph snapshot and its MST (see
+ * releaseClientInput); lines the client pipelined behind it are handled then,
+ * while its measurements may still run. Its reply keeps its place ahead of
+ * theirs through the ticket reserved when the request was read.
  */
-void processClientInput(int clientSocket, const string &input)
+void processClientInput(ConnectionId connection, const string &input)
 {
-    // Static variables to maintain state between function calls
-    static int state = 0;                        // Tracks the current state of input processing
-    static int n = 0, m = 0, edgeCount = 0;      // Graph parameters and edge count
-    static stringstream ss;                      // Stringstream for parsing input
-    static string algorithmName, threadingModel; // Selected algorithm and threading model
+    // The dialogue state of this client, kept between calls
+    ClientSession &session = sessions[connection];
+    int &state = session.state;
+    int &n = session.n, &m = session.m, &edgeCount = session.edgeCount;
+    string &algorithmName = session.algorithmName, &threadingModel = session.threadingModel;
 
-    istringstream iss(input); // Create input string stream
-    string command = input;
-    // Remove newline character from the command
-    command.erase(remove(command.begin(), command.end(), '\n'), command.end());
+    const string &command = input;
 
     switch (state)
     {
@@ -291,8 +1062,8 @@ void processClientInput(int clientSocket, const string &input)
         {
             // Handle invalid input by notifying the client and resending the menu
             string errorMsg = "Invalid choice. Please try again.\n";
-            send(clientSocket, errorMsg.c_str(), errorMsg.size(), 0);
-            sendMenu(clientSocket);
+            reactor->sendToClient(connection, errorMsg);
+            sendMenu(connection);
             return;
         }
 
@@ -301,47 +1072,91 @@ void processClientInput(int clientSocket, const string &input)
         {
             // Prompt for number of vertices if creating a new graph
             string prompt = "Enter number of vertices (n): ";
-            send(clientSocket, prompt.c_str(), prompt.size(), 0);
+            reactor->sendToClient(connection, prompt);
             state = 1; // Change state to expect number of vertices
         }
         else if (choice == 2)
         {
             // Prompt for edge details if adding an edge
             string prompt = "Enter edge to add (src dest weight): ";
-            send(clientSocket, prompt.c_str(), prompt.size(), 0);
+            reactor->sendToClient(connection, prompt);
             state = 4; // Change state to expect edge details
         }
         else if (choice == 3)
         {
             // Prompt for edge details if removing an edge
             string prompt = "Enter edge to remove (src dest): ";
-            send(clientSocket, prompt.c_str(), prompt.size(), 0);
+            reactor->sendToClient(connection, prompt);
             state = 5; // Change state to expect edge details
         }
         else if (choice == 4)
         {
             // Prompt to select MST algorithm
-            string prompt = "Select the algorithm:\n"
-                            "1) Prim\n"
-                            "2) Kruskal\n"
-                            "Enter your choice: ";
-            send(clientSocket, prompt.c_str(), prompt.size(), 0);
+            string prompt = algorithmMenu;
+            reactor->sendToClient(connection, prompt);
             state = 6; // Change state to expect algorithm choice
         }
         else if (choice == 5)
         {
             // Exit the connection
             string msg = "Exiting...\n";
-            send(clientSocket, msg.c_str(), msg.size(), 0);
-            close(clientSocket);   // Close client connection
-            pthread_exit(nullptr); // Exit the thread
+            reactor->sendToClient(connection, msg);
+            reactor->closeClient(connection); // Closed once the message is written
+        }
+        else if (choice == 6)
+        {
+            // List the graphs of all clients and prompt for the one to work on
+            evictIdleGraphs(); // Computations that held graphs may have finished since the last edit
+            stringstream prompt;
+            prompt << "Graphs (about " << graphStore.getMemoryUsage() / 1024 << " KiB of "
+                   << serverConfig.graphMemoryBudget / 1024 << " KiB in use):\n";
+            for (const GraphSummary &summary : graphStore.list())
+            {
+                prompt << (summary.name == session.graphName ? "* " : "  ") << summary.name << ": "
+                       << summary.vertices << " vertices, " << summary.edges << " edges"
+                       << (summary.mapped ? " (mapped file)\n" : "\n");
+            }
+            prompt << "Enter graph name (current: " << session.graphName << "): ";
+            reactor->sendToClient(connection, prompt.str());
+            state = 9; // Change state to expect a graph name
+        }
+        else if (choice == 7)
+        {
+            // Prompt for the file to save the selected graph to
+            string prompt =
+                "Enter file name (in the server's graph directory) to save graph '" + session.graphName + "' to: ";
+            reactor->sendToClient(connection, prompt);
+            state = 10; // Change state to expect a file path
+        }
+        else if (choice == 8)
+        {
+            // Prompt for the graph file to open as the selected graph
+            string prompt = "Enter name of the graph file (in the server's graph directory) to open as graph '" +
+                            session.graphName + "': ";
+            reactor->sendToClient(connection, prompt);
+            state = 11; // Change state to expect a file path
+        }
+        else if (choice == 9)
+        {
+            // Prompt for the trace level of the client's MST requests
+            string prompt = string("Computation trace is ") + traceLevelName(session.traceLevel) + ".\n" + traceMenu;
+            reactor->sendToClient(connection, prompt);
+            state = 12; // Change state to expect a trace level choice
+        }
+        else if (choice == 10)
+        {
+            // Prompt for the scope of the client's MST requests
+            string prompt = string("MST scope is ") + (session.spanningForest ? "spanning forest" : "spanning tree") +
+                            ".\n" + scopeMenu;
+            reactor->sendToClient(connection, prompt);
+            state = 13; // Change state to expect a scope choice
         }
         else
         {
             // Handle invalid choice by notifying the client and resending the menu
             string errorMsg = "Invalid choice. Please try again.\n";
-            send(clientSocket, errorMsg.c_str(), errorMsg.size(), 0);
-            sendMenu(clientSocket);
+            reactor->sendToClient(connection, errorMsg);
+            sendMenu(connection);
         }
         break;
     }
@@ -350,17 +1165,19 @@ void processClientInput(int clientSocket, const string &input)
         try
         {
             n = stoi(command); // Convert command to number of vertices
+            if (n < 0)
+                throw invalid_argument("negative vertex count");
         }
         catch (...)
         {
             // Handle invalid input by notifying the client and prompting again
             string errorMsg = "Invalid number. Please enter number of vertices (n): ";
-            send(clientSocket, errorMsg.c_str(), errorMsg.size(), 0);
+            reactor->sendToClient(connection, errorMsg);
             return;
         }
         // Prompt for number of edges
         string prompt = "Enter number of edges (m): ";
-        send(clientSocket, prompt.c_str(), prompt.size(), 0);
+        reactor->sendToClient(connection, prompt);
         state = 2; // Change state to expect number of edges
         break;
     }
@@ -374,21 +1191,30 @@ void processClientInput(int clientSocket, const string &input)
         {
             // Handle invalid input by notifying the client and prompting again
             string errorMsg = "Invalid number. Please enter number of edges (m): ";
-            send(clientSocket, errorMsg.c_str(), errorMsg.size(), 0);
+            reactor->sendToClient(connection, errorMsg);
             return;
         }
-        // Initialize the graph with the specified number of vertices
-        pthread_mutex_lock(&graphMutex);
-        delete g;         // Delete existing graph if any
-        g = new Graph(n); // Create new graph
-        pthread_mutex_unlock(&graphMutex);
+        // Initialize the selected graph with the specified number of vertices
+        session.graph = graphStore.findOrCreate(session.graphName);
+        GraphEntry &entry = *session.graph;
+        pthread_mutex_lock(&entry.mutex);
+        replaceGraph(entry, new Graph(n), nullptr); // Replaces the existing graph if any
+        pthread_mutex_unlock(&entry.mutex);
+        evictIdleGraphs();
+
+        edgeCount = 0; // Reset edge count
+        if (m <= 0)
+        {
+            sendMenu(connection); // No edges to collect
+            state = 0;
+            break;
+        }
 
         // Prompt for edge details in specific format
         string prompt = "Enter edges in format: src dest weight (x x x.x)\n";
         prompt += "Edge 0: ";
-        send(clientSocket, prompt.c_str(), prompt.size(), 0);
-        edgeCount = 0; // Reset edge count
-        state = 3;     // Change state to collect edges
+        reactor->sendToClient(connection, prompt);
+        state = 3; // Change state to collect edges
         break;
     }
     case 3:
@@ -400,24 +1226,31 @@ void processClientInput(int clientSocket, const string &input)
         {
             // Handle invalid edge format by notifying the client and prompting again
             string errorMsg = "Invalid edge format. Please enter edge (src dest weight (x x x.x)): ";
-            send(clientSocket, errorMsg.c_str(), errorMsg.size(), 0);
+            reactor->sendToClient(connection, errorMsg);
+            return;
+        }
+        GraphEntry *entry = lockSelectedGraph(session);
+        if (!entry || !validEdge(*entry, src, dest))
+        {
+            if (entry)
+                pthread_mutex_unlock(&entry->mutex);
+            string errorMsg = "Vertex out of range. Please enter edge (src dest weight (x x x.x)): ";
+            reactor->sendToClient(connection, errorMsg);
             return;
         }
-        pthread_mutex_lock(&graphMutex);
-        g->addEdge(src, dest, weight); // Add edge to graph
-        pthread_mutex_unlock(&graphMutex);
         edgeCount++; // Increment edge count
+        string prompt;
         if (edgeCount < m)
         {
             // Prompt for the next edge if more are expected
-            string prompt = "Edge " + to_string(edgeCount) + ": ";
-            send(clientSocket, prompt.c_str(), prompt.size(), 0);
+            prompt = "Edge " + to_string(edgeCount) + ": ";
         }
         else
         {
-            sendMenu(clientSocket);
+            prompt = mainMenu;
             state = 0; // Reset state to wait for the next main menu choice
         }
+        editGraph(connection, session.graph, GraphEdit{false, src, dest, weight}, prompt);
         break;
     }
     case 4:
@@ -429,22 +1262,24 @@ void processClientInput(int clientSocket, const string &input)
         {
             // Handle invalid edge format by notifying the client and prompting again
             string errorMsg = "Invalid edge format. Please enter edge to add (src dest weight): ";
-            send(clientSocket, errorMsg.c_str(), errorMsg.size(), 0);
+            reactor->sendToClient(connection, errorMsg);
             return;
         }
-        pthread_mutex_lock(&graphMutex);
-        if (g)
+        GraphEntry *entry = lockSelectedGraph(session);
+        if (entry && validEdge(*entry, src - 1, dest - 1))
         {
-            g->addEdge(src - 1, dest - 1, weight); // Add edge to graph
+            // Unlocks the graph and resends the menu once the edge is applied
+            editGraph(connection, session.graph, GraphEdit{false, src - 1, dest - 1, weight}, mainMenu);
         }
         else
         {
-            string msg = "No graph created yet.\n";
-            send(clientSocket, msg.c_str(), msg.size(), 0);
+            string msg = entry ? "Vertex out of range.\n" : "No graph created yet.\n";
+            if (entry)
+                pthread_mutex_unlock(&entry->mutex);
+            reactor->sendToClient(connection, msg);
+            sendMenu(connection); // Resend menu
         }
-        pthread_mutex_unlock(&graphMutex);
-        sendMenu(clientSocket); // Resend menu
-        state = 0;              // Reset state
+        state = 0; // Reset state
         break;
     }
     case 5:
@@ -455,22 +1290,24 @@ void processClientInput(int clientSocket, const string &input)
         {
             // Handle invalid edge format by notifying the client and prompting again
             string errorMsg = "Invalid edge format. Please enter edge to remove (src dest): ";
-            send(clientSocket, errorMsg.c_str(), errorMsg.size(), 0);
+            reactor->sendToClient(connection, errorMsg);
             return;
         }
-        pthread_mutex_lock(&graphMutex);
-        if (g)
+        GraphEntry *entry = lockSelectedGraph(session);
+        if (entry && validEdge(*entry, src - 1, dest - 1))
         {
-            g->removeEdge(src - 1, dest - 1); // Remove edge from graph
+            // Unlocks the graph and resends the menu once the edge is applied
+            editGraph(connection, session.graph, GraphEdit{true, src - 1, dest - 1, 0.0}, mainMenu);
         }
         else
         {
-            string msg = "No graph created yet.\n";
-            send(clientSocket, msg.c_str(), msg.size(), 0);
+            string msg = entry ? "Vertex out of range.\n" : "No graph created yet.\n";
+            if (entry)
+                pthread_mutex_unlock(&entry->mutex);
+            reactor->sendToClient(connection, msg);
+            sendMenu(connection); // Resend menu
         }
-        pthread_mutex_unlock(&graphMutex);
-        sendMenu(clientSocket); // Resend menu
-        state = 0;              // Reset state
+        state = 0; // Reset state
         break;
     }
     case 6:
@@ -483,29 +1320,19 @@ void processClientInput(int clientSocket, const string &input)
         catch (...)
         {
             // Handle invalid choice by notifying the client and prompting again
-            string errorMsg = "Invalid choice. Select the algorithm:\n"
-                              "1) Prim\n"
-                              "2) Kruskal\n"
-                              "Enter your choice: ";
-            send(clientSocket, errorMsg.c_str(), errorMsg.size(), 0);
+            string errorMsg = string("Invalid choice. ") + algorithmMenu;
+            reactor->sendToClient(connection, errorMsg);
             return;
         }
-        if (algChoice == 1)
+        if (algChoice >= 1 && algChoice <= numAlgorithmChoices)
         {
-            algorithmName = "Prim"; // Set algorithm to Prim if chosen
-        }
-        else if (algChoice == 2)
-        {
-            algorithmName = "Kruskal"; // Set algorithm to Kruskal if chosen
+            algorithmName = algorithmChoices[algChoice - 1]; // Set the algorithm the client picked
         }
         else
         {
             // Handle invalid choice by notifying the client and prompting again
-            string errorMsg = "Invalid choice. Select the algorithm:\n"
-                              "1) Prim\n"
-                              "2) Kruskal\n"
-                              "Enter your choice: ";
-            send(clientSocket, errorMsg.c_str(), errorMsg.size(), 0);
+            string errorMsg = string("Invalid choice. ") + algorithmMenu;
+            reactor->sendToClient(connection, errorMsg);
             return;
         }
         // Prompt to select threading model
@@ -513,7 +1340,7 @@ void processClientInput(int clientSocket, const string &input)
                         "1) Pipeline\n"
                         "2) Leader-Follower\n"
                         "Enter your choice: ";
-        send(clientSocket, prompt.c_str(), prompt.size(), 0);
+        reactor->sendToClient(connection, prompt);
         state = 7; // Change state to expect threading model choice
         break;
     }
@@ -531,7 +1358,7 @@ void processClientInput(int clientSocket, const string &input)
                               "1) Pipeline\n"
                               "2) Leader-Follower\n"
                               "Enter your choice: ";
-            send(clientSocket, errorMsg.c_str(), errorMsg.size(), 0);
+            reactor->sendToClient(connection, errorMsg);
             return;
         }
         if (threadingChoice == 1)
@@ -549,40 +1376,184 @@ void processClientInput(int clientSocket, const string &input)
                               "1) Pipeline\n"
                               "2) Leader-Follower\n"
                               "Enter your choice: ";
-            send(clientSocket, errorMsg.c_str(), errorMsg.size(), 0);
+            reactor->sendToClient(connection, errorMsg);
+            return;
+        }
+        // Prompt to select how the average distance is computed
+        string prompt = averageModeMenu();
+        reactor->sendToClient(connection, prompt);
+        state = 8; // Change state to expect average distance mode choice
+        break;
+    }
+    case 8:
+    { // Select average distance mode
+        int modeChoice;
+        try
+        {
+            modeChoice = stoi(command); // Convert command to average distance mode choice
+        }
+        catch (...)
+        {
+            modeChoice = 0;
+        }
+        if (modeChoice < 1 || modeChoice > 3)
+        {
+            // Handle invalid choice by notifying the client and prompting again
+            string errorMsg = "Invalid choice. " + averageModeMenu();
+            reactor->sendToClient(connection, errorMsg);
             return;
         }
+        AverageDistanceMode averageMode = modeChoice == 1   ? AverageDistanceMode::Exact
+                                          : modeChoice == 2 ? AverageDistanceMode::Approximate
+                                                            : AverageDistanceMode::Auto;
+
         // Compute MST using the selected algorithm and threading model
-        pthread_mutex_lock(&graphMutex);
-        if (g)
+        GraphEntry *entry = lockSelectedGraph(session);
+        if (entry)
         {
-            pthread_mutex_unlock(&graphMutex);
+            pthread_mutex_unlock(&entry->mutex);
+
+            // Lines the client sent after this one wait until the request has
+            // its snapshot; whatever they send back waits for the result
+            uint64_t replyTicket = reactor->reserveReply(connection);
+            reactor->pauseInput(connection);
             if (threadingModel == "Pipeline")
             {
                 // Perform computation using the Pipeline pattern
-                computeMSTWithPipeline(clientSocket, algorithmName);
+                computeMSTWithPipeline(connection, replyTicket, session.graph, algorithmName, averageMode,
+                                       session.traceLevel, session.spanningForest);
             }
             else if (threadingModel == "LeaderFollower")
             {
                 // Perform computation using the Leader-Follower Thread Pool
-                computeMSTWithThreadPool(clientSocket, algorithmName);
+                computeMSTWithThreadPool(connection, replyTicket, session.graph, algorithmName, averageMode,
+                                         session.traceLevel, session.spanningForest);
             }
             state = 0; // Reset state to wait for the next main menu choice
         }
         else
         {
-            pthread_mutex_unlock(&graphMutex);
-
-            sendMenu(clientSocket);
+            sendMenu(connection);
             state = 0; // Reset state
         }
         break;
     }
+    case 9:
+    { // Select a graph by name
+        string name;
+        istringstream nameStream(command);
+        if (!(nameStream >> name))
+        {
+            // Handle an empty name by prompting again
+            string errorMsg = "Invalid name. Enter graph name: ";
+            reactor->sendToClient(connection, errorMsg);
+            return;
+        }
+        session.graphName = name;
+        session.graph = graphStore.find(name);
+        string msg = "Selected graph '" + name + "'" +
+                     (session.graph ? ".\n" : " (empty; create it with option 1 or a binary upload).\n");
+        reactor->sendToClient(connection, msg);
+        evictIdleGraphs(); // The previously selected graph may be idle now
+        sendMenu(connection);
+        state = 0; // Reset state
+        break;
+    }
+    case 10:
+    { // Save the graph to a file
+        string path = graphFilePath(command);
+        if (path.empty())
+        {
+            string errorMsg = "Invalid file name (relative to the graph directory, without \"..\"). Enter file name: ";
+            reactor->sendToClient(connection, errorMsg);
+            return;
+        }
+        GraphEntry *entry = lockSelectedGraph(session);
+        if (!entry)
+        {
+            string msg = "No graph created yet.\n";
+            reactor->sendToClient(connection, msg);
+            sendMenu(connection);
+            state = 0;
+            break;
+        }
+        pthread_mutex_unlock(&entry->mutex);
+        saveGraphToFile(connection, session.graph, path);
+        state = 0; // Reset state
+        break;
+    }
+    case 11:
+    { // Open a graph file
+        string path = graphFilePath(command);
+        if (path.empty())
+        {
+            string errorMsg = "Invalid file name (relative to the graph directory, without \"..\"). Enter file name: ";
+            reactor->sendToClient(connection, errorMsg);
+            return;
+        }
+        session.graph = graphStore.findOrCreate(session.graphName);
+        openGraphFromFile(connection, session.graph, path);
+        state = 0; // Reset state
+        break;
+    }
+    case 12:
+    { // Select the computation trace level
+        int traceChoice;
+        try
+        {
+            traceChoice = stoi(command); // Convert command to trace level choice
+        }
+        catch (...)
+        {
+            traceChoice = 0;
+        }
+        if (traceChoice < 1 || traceChoice > 3)
+        {
+            // Handle invalid choice by notifying the client and prompting again
+            string errorMsg = string("Invalid choice. ") + traceMenu;
+            reactor->sendToClient(connection, errorMsg);
+            return;
+        }
+        session.traceLevel = traceChoice == 1   ? TraceLevel::Off
+                             : traceChoice == 2 ? TraceLevel::Summary
+                                                : TraceLevel::Full;
+        string msg = string("Computation trace set to ") + traceLevelName(session.traceLevel) + ".\n";
+        reactor->sendToClient(connection, msg);
+        sendMenu(connection);
+        state = 0; // Reset state
+        break;
+    }
+    case 13:
+    { // Select the MST scope
+        int scopeChoice;
+        try
+        {
+            scopeChoice = stoi(command); // Convert command to scope choice
+        }
+        catch (...)
+        {
+            scopeChoice = 0;
+        }
+        if (scopeChoice < 1 || scopeChoice > 2)
+        {
+            // Handle invalid choice by notifying the client and prompting again
+            string errorMsg = string("Invalid choice. ") + scopeMenu;
+            reactor->sendToClient(connection, errorMsg);
+            return;
+        }
+        session.spanningForest = scopeChoice == 2;
+        string msg = string("MST scope set to ") + (session.spanningForest ? "spanning forest" : "spanning tree") +
+                     ".\n";
+        reactor->sendToClient(connection, msg);
+        sendMenu(connection);
+        state = 0; // Reset state
+        break;
+    }
     default:
     {
         // Reset state and send menu in case of unexpected state
         state = 0;
-        sendMenu(clientSocket);
+        sendMenu(connection);
         break;
     }
     }
@@ -3,16 +3,66 @@
 #define SERVER_H
 
 #include "ThreadPool.h"
-#include "ActiveObject.h"
+#include "PipelineStage.h"
+#include "Reactor.h"
+#include "GraphStore.h"
+#include "GraphFile.h"
+#include "ComputationTrace.h"
+#include <string>
+#include <vector>
+#include <memory>
 
+// How the "Average Distance in Graph" of a compute request is obtained
+enum class AverageDistanceMode
+{
+    Exact,       // Dijkstra from every vertex
+    Approximate, // Dijkstra from sampled vertices, with a confidence interval
+    Auto         // Approximate only above serverConfig.approximateAboveVertices
+};
+
+// Server settings chosen at startup (see main.cpp for the command-line options)
+struct ServerConfig
+{
+    int approximateAboveVertices = 2000;    // Auto mode switches to sampling above this many vertices
+    double approximateTargetError = 0.01;   // Relative 95% half-width the sampling stops at
+    double approximateTimeBudget = 1.0;     // Seconds the sampling may spend at most
+    int stageReplicas[4] = {1, 1, 1, 1};    // Worker threads of each pipeline stage
+    size_t graphMemoryBudget = 1024u << 20; // Bytes the named graphs may take before idle ones are evicted
+    GraphMapHints mapHints;                 // Kernel hints for graph files opened with option 8
+    std::string graphDirectory = "graphs";  // Options 7 and 8 only read and write graph files in here
+    int64_t maxUploadEdges = 1 << 24;       // Binary uploads of more edges are refused (256 MiB of records)
+};
+
+extern ServerConfig serverConfig;
+
+// Where one client is in the menu dialogue, and what it has chosen so far
+struct ClientSession
+{
+    int state = 0;                     // Tracks the current state of input processing
+    int n = 0, m = 0;                  // Graph parameters of "Create a new graph"
+    int edgeCount = 0;                 // Edges received so far in state 3
+    std::string algorithmName;         // Selected algorithm
+    std::string threadingModel;        // Selected threading model
+    std::string graphName = "default"; // Graph the commands work on (see option 6)
+    std::shared_ptr<GraphEntry> graph; // That graph once it exists; keeps it from being evicted
+    TraceLevel traceLevel = TraceLevel::Off; // Computation trace of its MST requests (see option 9)
+    bool spanningForest = false;             // MST requests compute a tree per component (see option 10)
+};
+
+extern Reactor* reactor; // Owns every client socket; replies go through reactor->sendToClient()
 extern ThreadPool threadPool;
-extern ActiveObject* stage1Pipeline;
-extern ActiveObject* stage2Pipeline;
-extern ActiveObject* stage3Pipeline;
-extern ActiveObject* stage4Pipeline;
-
-void* handleClient(void* arg);
-void computeMSTWithPipeline(int clientSocket, const std::string& algorithmName);
-void computeMSTWithThreadPool(int clientSocket, const std::string& algorithmName);
+extern PipelineStage* stage1Pipeline;
+extern PipelineStage* stage2Pipeline;
+extern PipelineStage* stage3Pipeline;
+extern PipelineStage* stage4Pipeline;
+
+void sendMenu(ConnectionId connection);
+void openSession(ConnectionId connection);
+void closeSession(ConnectionId connection);
+void processClientInput(ConnectionId connection, const std::string& input);
+bool acceptsBulkUpload(ConnectionId connection);
+void processBulkUpload(ConnectionId connection, const BulkHeader& header, std::vector<BulkEdge>&& edges);
+void computeMSTWithPipeline(ConnectionId connection, uint64_t replyTicket, const std::shared_ptr<GraphEntry>& graph, const std::string& algorithmName, AverageDistanceMode averageMode, TraceLevel traceLevel, bool spanningForest);
+void computeMSTWithThreadPool(ConnectionId connection, uint64_t replyTicket, const std::shared_ptr<GraphEntry>& graph, const std::string& algorithmName, AverageDistanceMode averageMode, TraceLevel traceLevel, bool spanningForest);
 
 #endif // SERVER_H
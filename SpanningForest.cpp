@@ -0,0 +1,166 @@
+// SpanningForest.cpp
+#include "SpanningForest.h"
+#include "ConcurrentDisjointSet.h"
+#include "MSTFactory.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+GraphComponents findComponents(const CSRGraph &graph)
+{
+    int V = graph.getNumVertices();
+    ConcurrentDisjointSet ds(V);
+    parallelFor(0, V, [&](size_t begin, size_t end, unsigned)
+                {
+        for (size_t u = begin; u < end; ++u)
+        {
+            for (size_t i = graph.begin(u); i < graph.end(u); ++i)
+            {
+                if (u < static_cast<size_t>(graph.neighbor(i))) // Each undirected edge once
+                    ds.unite(u, graph.neighbor(i));
+            }
+        } });
+
+    // Number the sets in the order of their smallest vertex
+    GraphComponents components;
+    components.componentOf.resize(V);
+    std::vector<int> componentOfRoot(V, -1);
+    for (int u = 0; u < V; ++u)
+    {
+        int root = ds.find(u);
+        if (componentOfRoot[root] == -1)
+        {
+            componentOfRoot[root] = components.count();
+            components.sizes.push_back(0);
+        }
+        components.componentOf[u] = componentOfRoot[root];
+        ++components.sizes[componentOfRoot[root]];
+    }
+    return components;
+}
+
+namespace
+{
+    /**
+     * Computes the MST of one component on a CSR graph of its own, in which the
+     * component's vertices are numbered 0..size-1 in increasing order, and maps
+     * its edges back. members lists the component's vertices in that order.
+     * The kernel sees a connected graph, so Prim's variants span all of it.
+     */
+    std::vector<Edge> componentMST(const CSRGraph &graph, const int *members, int size,
+                                   const std::vector<int> &localId, const std::string &algorithmName,
+                                   ComputationTrace &trace, std::string &kernelName)
+    {
+        std::unique_ptr<MSTAlgorithm> algorithm(MSTFactory::createAlgorithm(algorithmName));
+        if (size == graph.getNumVertices())
+        {
+            // A connected graph is its own component; no copy needed
+            std::vector<Edge> treeEdges = algorithm->computeMST(graph, trace);
+            kernelName = algorithm->getName();
+            return treeEdges;
+        }
+
+        std::vector<Edge> localEdges;
+        for (int local = 0; local < size; ++local)
+        {
+            int u = members[local];
+            for (size_t i = graph.begin(u); i < graph.end(u); ++i)
+            {
+                if (u < graph.neighbor(i))
+                    localEdges.emplace_back(local, localId[graph.neighbor(i)], graph.weight(i));
+            }
+        }
+        CSRGraph component(size, localEdges);
+        localEdges.clear();
+        localEdges.shrink_to_fit();
+
+        std::vector<Edge> treeEdges = algorithm->computeMST(component, trace);
+        kernelName = algorithm->getName();
+        for (Edge &edge : treeEdges)
+        {
+            edge.src = members[edge.src];
+            edge.dest = members[edge.dest];
+        }
+        return treeEdges;
+    }
+}
+
+std::vector<Edge> computeSpanningForest(const CSRGraph &graph, const GraphComponents &components,
+                                        const std::string &algorithmName, ComputationTrace &trace,
+                                        std::string &kernelName)
+{
+    int V = graph.getNumVertices();
+    int count = components.count();
+
+    // Group the vertices by component (counting sort, so each group stays in increasing order)
+    std::vector<size_t> offsets(count + 1, 0);
+    for (int c = 0; c < count; ++c)
+        offsets[c + 1] = offsets[c] + components.sizes[c];
+    std::vector<int> members(V);
+    std::vector<int> localId(V);
+    std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+    for (int u = 0; u < V; ++u)
+    {
+        size_t position = next[components.componentOf[u]]++;
+        members[position] = u;
+        localId[u] = static_cast<int>(position - offsets[components.componentOf[u]]);
+    }
+
+    // Components with an edge, largest first so the long runs start early
+    std::vector<int> work;
+    for (int c = 0; c < count; ++c)
+    {
+        if (components.sizes[c] > 1)
+            work.push_back(c);
+    }
+    std::stable_sort(work.begin(), work.end(), [&components](int a, int b)
+                     { return components.sizes[a] > components.sizes[b]; });
+
+    trace.note("Spanning forest of ", count, " components (", count - static_cast<int>(work.size()),
+               " isolated vertices) with ", algorithmName, ":");
+    std::vector<std::vector<Edge>> treeEdges(count);
+    std::vector<std::string> kernelNames(count);
+    if (trace.enabled())
+    {
+        for (int c : work)
+        {
+            // The kernel's steps use the component's own vertex numbers
+            trace.note("Component of vertex ", members[offsets[c]], " (", components.sizes[c],
+                       " vertices, numbered from 0 in increasing order below):");
+            treeEdges[c] = componentMST(graph, &members[offsets[c]], components.sizes[c], localId, algorithmName,
+                                        trace, kernelNames[c]);
+        }
+    }
+    else
+    {
+        std::atomic<size_t> nextWork(0);
+        parallelFor(0, parallelWorkerCount(), [&](size_t, size_t, unsigned)
+                    {
+            ComputationTrace untraced;
+            for (size_t k = nextWork++; k < work.size(); k = nextWork++)
+            {
+                int c = work[k];
+                treeEdges[c] = componentMST(graph, &members[offsets[c]], components.sizes[c], localId,
+                                            algorithmName, untraced, kernelNames[c]);
+            } }, 1);
+    }
+
+    // The kernels that ran, in the order they first appear ("Auto" may pick different ones)
+    std::vector<Edge> forest;
+    forest.reserve(V - count);
+    kernelName.clear();
+    std::vector<std::string> seen;
+    for (int c = 0; c < count; ++c)
+    {
+        forest.insert(forest.end(), treeEdges[c].begin(), treeEdges[c].end());
+        if (!kernelNames[c].empty() && std::find(seen.begin(), seen.end(), kernelNames[c]) == seen.end())
+        {
+            seen.push_back(kernelNames[c]);
+            kernelName += (kernelName.empty() ? "" : ", ") + kernelNames[c];
+        }
+    }
+    if (kernelName.empty())
+        kernelName = algorithmName;
+    return forest;
+}
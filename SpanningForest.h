@@ -0,0 +1,39 @@
+// SpanningForest.h
+#ifndef SPANNINGFOREST_H
+#define SPANNINGFOREST_H
+
+#include <vector>
+#include <string>
+#include "Edge.h"
+#include "CSRGraph.h"
+#include "ComputationTrace.h"
+
+// Connected components of a graph, numbered in the order of their smallest vertex
+struct GraphComponents
+{
+    std::vector<int> componentOf; // Component of every vertex
+    std::vector<int> sizes;       // Number of vertices of every component
+
+    int count() const { return static_cast<int>(sizes.size()); }
+};
+
+// Finds the components with a lock-free union-find over all edges, in parallel
+GraphComponents findComponents(const CSRGraph &graph);
+
+/**
+ * @brief Computes a minimum spanning forest: one MST per component, each
+ * computed by the named MSTFactory algorithm on a CSR graph of its own.
+ *
+ * Components are independent, so untraced runs are spread over parallelFor
+ * workers, largest component first; a traced run computes them one after
+ * the other, since a trace is used by one thread at a time. Isolated
+ * vertices need no run.
+ *
+ * @param kernelName Set to the kernel(s) that ran, see MSTAlgorithm::getName().
+ * @return The forest's edges, component by component.
+ */
+std::vector<Edge> computeSpanningForest(const CSRGraph &graph, const GraphComponents &components,
+                                        const std::string &algorithmName, ComputationTrace &trace,
+                                        std::string &kernelName);
+
+#endif // SPANNINGFOREST_H
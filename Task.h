@@ -0,0 +1,142 @@
+// Task.h
+#ifndef TASK_H
+#define TASK_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Move-only, type-erased void() callable with a small inline buffer.
+ *
+ * Replaces std::function<void()> where tasks are handed from thread to
+ * thread. Callables of up to INLINE_SIZE bytes (e.g. a lambda capturing a
+ * std::unique_ptr and a few scalars) are stored inside the Task itself, so
+ * creating, moving and running one does not allocate; larger ones fall back
+ * to the heap. Unlike std::function, move-only captures are allowed, so large
+ * state can be moved along instead of copied.
+ */
+class Task
+{
+public:
+    static const size_t INLINE_SIZE = 64;
+
+    Task() noexcept : ops(nullptr) {}
+
+    template <typename F, typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, Task>::value>::type>
+    Task(F &&function) : ops(nullptr)
+    {
+        typedef typename std::decay<F>::type Callable;
+        emplace<Callable>(std::forward<F>(function), std::integral_constant<bool, fitsInline<Callable>()>());
+    }
+
+    Task(Task &&other) noexcept : ops(other.ops)
+    {
+        if (ops)
+        {
+            ops->moveTo(other.storage, storage);
+            other.ops = nullptr;
+        }
+    }
+
+    Task &operator=(Task &&other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            if (other.ops)
+            {
+                other.ops->moveTo(other.storage, storage);
+                ops = other.ops;
+                other.ops = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+
+    ~Task() { reset(); }
+
+    void operator()() { ops->invoke(storage); }
+
+    explicit operator bool() const { return ops != nullptr; }
+
+    void reset()
+    {
+        if (ops)
+        {
+            ops->destroy(storage);
+            ops = nullptr;
+        }
+    }
+
+private:
+    // What the type-erased storage can do; one static table per callable type and placement
+    struct Ops
+    {
+        void (*invoke)(void *storage);
+        void (*moveTo)(void *from, void *to); // Move-constructs into 'to' and destroys 'from'
+        void (*destroy)(void *storage);
+    };
+
+    template <typename Callable>
+    static constexpr bool fitsInline()
+    {
+        return sizeof(Callable) <= INLINE_SIZE && alignof(Callable) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible<Callable>::value;
+    }
+
+    template <typename Callable>
+    struct InlineOps
+    {
+        static Callable *get(void *storage) { return static_cast<Callable *>(storage); }
+        static void invoke(void *storage) { (*get(storage))(); }
+        static void moveTo(void *from, void *to)
+        {
+            new (to) Callable(std::move(*get(from)));
+            get(from)->~Callable();
+        }
+        static void destroy(void *storage) { get(storage)->~Callable(); }
+        static const Ops table;
+    };
+
+    template <typename Callable>
+    struct HeapOps
+    {
+        static Callable *&get(void *storage) { return *static_cast<Callable **>(storage); }
+        static void invoke(void *storage) { (*get(storage))(); }
+        static void moveTo(void *from, void *to) { new (to) Callable *(get(from)); }
+        static void destroy(void *storage) { delete get(storage); }
+        static const Ops table;
+    };
+
+    template <typename Callable, typename F>
+    void emplace(F &&function, std::true_type)
+    {
+        new (storage) Callable(std::forward<F>(function));
+        ops = &InlineOps<Callable>::table;
+    }
+
+    template <typename Callable, typename F>
+    void emplace(F &&function, std::false_type)
+    {
+        new (storage) Callable *(new Callable(std::forward<F>(function)));
+        ops = &HeapOps<Callable>::table;
+    }
+
+    alignas(std::max_align_t) unsigned char storage[INLINE_SIZE];
+    const Ops *ops;
+};
+
+template <typename Callable>
+const Task::Ops Task::InlineOps<Callable>::table = {&InlineOps<Callable>::invoke, &InlineOps<Callable>::moveTo,
+                                                    &InlineOps<Callable>::destroy};
+
+template <typename Callable>
+const Task::Ops Task::HeapOps<Callable>::table = {&HeapOps<Callable>::invoke, &HeapOps<Callable>::moveTo,
+                                                  &HeapOps<Callable>::destroy};
+
+#endif // TASK_H
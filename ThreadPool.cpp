@@ -1,61 +1,141 @@
 // ThreadPool.cpp
 #include "ThreadPool.h"
-#include <iostream>
+#include <stdexcept>
+
+namespace
+{
+    // Pool and worker index of the current thread, so tasks enqueued by a worker go to its own deque
+    thread_local const void *currentPool = nullptr;
+    thread_local size_t currentWorker = 0;
+
+    // Rounds of failed searches before an idle worker parks
+    const int SPIN_ROUNDS = 64;
+}
 
 /**
  * @brief Creates a ThreadPool with a specified number of threads.
  *
- * The constructor creates a number of worker threads and starts them. The
- * threads are waiting for tasks to be enqueued and will execute them
- * sequentially.
+ * The constructor creates one deque per worker and then starts the worker
+ * threads, which look for tasks until the pool is destroyed.
  *
  * @param threads The number of worker threads to create.
  */
-ThreadPool::ThreadPool(size_t threads) : stop(false)
+ThreadPool::ThreadPool(size_t threads) : injectionSize(0), parkedWorkers(0), stop(false)
 {
     for (size_t i = 0; i < threads; ++i)
+        queues.emplace_back(new WorkerQueue());
+    for (size_t i = 0; i < threads; ++i)
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+/**
+ * @brief Main loop of worker 'index'.
+ *
+ * Runs tasks while it can find any. After SPIN_ROUNDS empty searches it parks;
+ * before waiting it re-checks all queues under the park lock, and enqueueTask
+ * checks for parked workers after publishing its task, so a wake-up cannot be
+ * lost in between.
+ */
+void ThreadPool::workerLoop(size_t index)
+{
+    currentPool = this;
+    currentWorker = index;
+    unsigned stealSeed = static_cast<unsigned>(index) * 2654435761u + 1;
+
+    int idleRounds = 0;
+    while (true)
+    {
+        Task *task = findTask(index, stealSeed);
+        if (task)
+        {
+            idleRounds = 0;
+            (*task)();
+            delete task;
+            continue;
+        }
+
+        if (stop.load(std::memory_order_acquire))
+            return; // Stopped and nothing left to run
+
+        if (++idleRounds < SPIN_ROUNDS)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(parkMutex);
+        parkedWorkers.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!stop.load(std::memory_order_acquire) && !hasVisibleWork())
+            parkCondition.wait(lock);
+        parkedWorkers.fetch_sub(1, std::memory_order_relaxed);
+        idleRounds = 0;
+    }
+}
+
+/**
+ * @brief Takes the next task for worker 'index': own deque first (newest task,
+ * still warm in cache), then the injection queue, then the oldest task of
+ * another worker, visiting the victims from a pseudo-random start.
+ */
+ThreadPool::Task *ThreadPool::findTask(size_t index, unsigned &stealSeed)
+{
+    Task *task = nullptr;
+    if (queues[index]->deque.pop(task))
+        return task;
+
+    if (injectionSize.load(std::memory_order_acquire) > 0)
     {
-        workers.emplace_back([this, i]
-                             {
-            while(true) 
-            {
-                std::function<void()> task;
-                {
-                    std::unique_lock<std::mutex> lock(this->queueMutex);
-
-                    // Wait until either the pool is stopped or there is a task to process
-                    this->condition.wait(lock,
-                        [this]{ return this->stop || !this->tasks.empty(); });
-
-                    if(this->stop && this->tasks.empty())
-                    {
-                        // If the pool is stopped and there are no tasks left, exit the loop
-                        return;
-                    }
-
-                    // This thread becomes the leader and dequeues the task
-                    std::cout << "Thread " << i << " is the leader.\n";
-
-                    task = std::move(this->tasks.front());
-                    this->tasks.pop();
-                }
-
-                // Execute the task
-                task();
-
-                // After completing, promote a follower to leader
-                std::cout << "Thread " << i << " completed task and is promoting a new leader.\n";
-                this->condition.notify_one();  // Notify next follower
-            } });
+        std::lock_guard<std::mutex> lock(injectionMutex);
+        if (!injection.empty())
+        {
+            task = injection.front();
+            injection.pop_front();
+            injectionSize.store(injection.size(), std::memory_order_release);
+            return task;
+        }
+    }
+
+    size_t n = queues.size();
+    stealSeed = stealSeed * 1103515245u + 12345u;
+    size_t start = stealSeed % n;
+    for (size_t k = 0; k < n; ++k)
+    {
+        size_t victim = (start + k) % n;
+        if (victim != index && queues[victim]->deque.steal(task))
+            return task;
+    }
+    return nullptr;
+}
+
+bool ThreadPool::hasVisibleWork() const
+{
+    if (injectionSize.load(std::memory_order_acquire) > 0)
+        return true;
+    for (const auto &queue : queues)
+    {
+        if (!queue->deque.empty())
+            return true;
+    }
+    return false;
+}
+
+void ThreadPool::wakeWorker()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (parkedWorkers.load(std::memory_order_seq_cst) > 0)
+    {
+        std::lock_guard<std::mutex> lock(parkMutex);
+        parkCondition.notify_one();
     }
 }
 
 /**
  * @brief Enqueues a task for execution by one of the worker threads.
  *
- * This function adds a task to the task queue and notifies one waiting
- * thread that a new task is available. If the pool is stopped, it is not
- * possible to enqueue new tasks.
+ * A worker of this pool pushes onto its own deque without any lock; any other
+ * thread appends to the injection queue. Either way a parked worker is woken
+ * if there is one.
  *
  * @param task The task to enqueue.
  *
@@ -63,45 +143,39 @@ ThreadPool::ThreadPool(size_t threads) : stop(false)
  */
 void ThreadPool::enqueueTask(std::function<void()> task)
 {
-    // Acquire a lock to ensure thread safety while modifying the task queue
-    {
-        std::unique_lock<std::mutex> lock(queueMutex);
-
-        // If the pool is stopped, it is not possible to enqueue new tasks
-        if (stop)
-            throw std::runtime_error("enqueue on stopped ThreadPool");
+    if (stop.load(std::memory_order_acquire))
+        throw std::runtime_error("enqueue on stopped ThreadPool");
 
-        // Move the task into the task queue
-        tasks.push(std::move(task));
+    Task *item = new Task(std::move(task));
+    if (currentPool == this)
+    {
+        queues[currentWorker]->deque.push(item);
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(injectionMutex);
+        injection.push_back(item);
+        injectionSize.store(injection.size(), std::memory_order_release);
     }
 
-    // Notify one waiting thread that a new task is available
-    condition.notify_one();
+    wakeWorker();
 }
 
 /**
  * @brief Stops the ThreadPool and waits for all threads to finish.
  *
- * This destructor sets a stop flag to signal to all threads that they should stop
- * and notifies all waiting threads that the pool is stopped and that there may be
- * tasks available to process. This will cause all threads to exit the loop.
- * Finally, it waits for all threads to finish by calling join on each thread.
+ * This destructor sets a stop flag and wakes every parked worker. Workers keep
+ * running until they find no task anywhere, so tasks enqueued before the
+ * destructor still run. Finally, it waits for all threads to finish by calling
+ * join on each thread.
  */
 ThreadPool::~ThreadPool()
 {
-    // Acquire a lock to ensure thread safety when stopping the thread pool
-    std::unique_lock<std::mutex> lock(queueMutex);
-
-    // Set the stop flag to true to signal to all threads that they should stop
-    stop = true;
-
-    // Notify all waiting threads that the pool is stopped and that there may be tasks
-    // available to process. This will cause all threads to exit the loop.
     {
-        std::unique_lock<std::mutex> lock(queueMutex);
-        stop = true;
+        std::lock_guard<std::mutex> lock(parkMutex);
+        stop.store(true, std::memory_order_release);
     }
-    condition.notify_all();
+    parkCondition.notify_all();
 
     // Wait for all threads to finish
     for (std::thread &worker : workers)
@@ -109,4 +183,14 @@ ThreadPool::~ThreadPool()
         // Join each thread to wait for it to finish
         worker.join();
     }
+
+    // Tasks enqueued by a task during shutdown may be left over
+    Task *task = nullptr;
+    for (auto &queue : queues)
+    {
+        while (queue->deque.pop(task))
+            delete task;
+    }
+    for (Task *leftover : injection)
+        delete leftover;
 }
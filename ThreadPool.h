@@ -3,20 +3,50 @@
 #define THREADPOOL_H
 
 #include <vector>
+#include <deque>
 #include <thread>
-#include <queue>
 #include <mutex>
 #include <condition_variable>
 #include <functional>
+#include <atomic>
+#include <memory>
+#include "ChaseLevDeque.h"
 
+/**
+ * @brief Work-stealing thread pool.
+ *
+ * Every worker owns a Chase-Lev deque. Tasks enqueued by a worker go to its
+ * own deque; tasks enqueued from outside the pool go to a global injection
+ * queue. An idle worker looks in its own deque, then the injection queue, then
+ * steals from the other workers, and parks on a condition variable only when
+ * all of them are empty. Enqueuing only takes the park lock to wake a worker
+ * when one is actually parked.
+ */
 class ThreadPool
 {
+    typedef std::function<void()> Task;
+
+    struct WorkerQueue
+    {
+        ChaseLevDeque<Task *> deque;
+    };
+
     std::vector<std::thread> workers;
-    std::queue<std::function<void()>> tasks;
+    std::vector<std::unique_ptr<WorkerQueue>> queues; // One per worker, same index
+
+    std::mutex injectionMutex;
+    std::deque<Task *> injection;         // Tasks submitted from outside the pool
+    std::atomic<size_t> injectionSize;    // injection.size(), readable without the lock
+
+    std::mutex parkMutex;
+    std::condition_variable parkCondition;
+    std::atomic<int> parkedWorkers;
+    std::atomic<bool> stop;
 
-    std::mutex queueMutex;
-    std::condition_variable condition;
-    bool stop;
+    void workerLoop(size_t index);
+    Task *findTask(size_t index, unsigned &stealSeed);
+    bool hasVisibleWork() const;
+    void wakeWorker();
 
 public:
     ThreadPool(size_t threads);
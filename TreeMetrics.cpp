@@ -0,0 +1,145 @@
+// TreeMetrics.cpp
+#include "TreeMetrics.h"
+#include <limits>
+
+// Builds the tree's adjacency in CSR form, reusing the buffers of earlier calls
+void TreeMetrics::buildAdjacency(int numVertices, const std::vector<Edge> &treeEdges)
+{
+    offsets.assign(numVertices + 1, 0);
+    for (const auto &edge : treeEdges)
+    {
+        offsets[edge.src + 1]++;
+        offsets[edge.dest + 1]++;
+    }
+    for (int u = 0; u < numVertices; ++u)
+        offsets[u + 1] += offsets[u];
+
+    neighbors.resize(treeEdges.size() * 2);
+    weights.resize(treeEdges.size() * 2);
+    // subtreeSize doubles as the scatter cursor here; it is reset before use
+    subtreeSize.assign(offsets.begin(), offsets.end() - 1);
+    for (const auto &edge : treeEdges)
+    {
+        size_t i = subtreeSize[edge.src]++;
+        neighbors[i] = edge.dest;
+        weights[i] = edge.weight;
+        size_t j = subtreeSize[edge.dest]++;
+        neighbors[j] = edge.src;
+        weights[j] = edge.weight;
+    }
+}
+
+/**
+ * Iterative breadth-first traversal of the tree containing start. Records the
+ * distance from start, the parent (and parent edge weight) of every vertex and
+ * the visiting order, in which every parent comes before its children.
+ */
+int TreeMetrics::traverse(int start)
+{
+    order.clear();
+    order.push_back(start);
+    dist[start] = 0.0;
+    parent[start] = -1;
+    parentWeight[start] = 0.0;
+
+    int farthest = start;
+    // 'order' doubles as the work list: entries past 'next' are still to be expanded
+    for (size_t next = 0; next < order.size(); ++next)
+    {
+        int u = order[next];
+        if (dist[u] > dist[farthest])
+            farthest = u;
+        for (size_t i = offsets[u]; i < offsets[u + 1]; ++i)
+        {
+            int v = neighbors[i];
+            if (v == parent[u])
+                continue;
+            parent[v] = u;
+            parentWeight[v] = weights[i];
+            dist[v] = dist[u] + weights[i];
+            order.push_back(v);
+        }
+    }
+    return farthest;
+}
+
+/**
+ * @brief Computes the diameter, lightest edge and pairwise distance sum of a forest.
+ * @param numVertices Number of vertices of the graph the forest spans.
+ * @param treeEdges The edges of the spanning tree or forest.
+ */
+TreeDistances TreeMetrics::compute(int numVertices, const std::vector<Edge> &treeEdges)
+{
+    std::vector<TreeDistances> results(1);
+    measure(numVertices, treeEdges, nullptr, results);
+    return results[0];
+}
+
+std::vector<TreeDistances> TreeMetrics::computePerTree(int numVertices, const std::vector<Edge> &treeEdges,
+                                                       const std::vector<int> &treeOf, int numTrees)
+{
+    std::vector<TreeDistances> results(numTrees);
+    measure(numVertices, treeEdges, treeOf.data(), results);
+    return results;
+}
+
+/**
+ * Accumulates the metrics of every tree into results[treeOf[root]], or into
+ * results[0] if treeOf is null: the diameter is the largest one, the lightest
+ * edge the lightest one, and the sums and pair counts add up.
+ */
+void TreeMetrics::measure(int numVertices, const std::vector<Edge> &treeEdges, const int *treeOf,
+                          std::vector<TreeDistances> &results)
+{
+    if (numVertices <= 1 || treeEdges.empty())
+        return;
+
+    buildAdjacency(numVertices, treeEdges);
+    dist.assign(numVertices, 0.0);
+    parent.assign(numVertices, -1);
+    parentWeight.assign(numVertices, 0.0);
+    subtreeSize.assign(numVertices, 1);
+    visited.assign(numVertices, false);
+
+    std::vector<double> lightest(results.size(), std::numeric_limits<double>::infinity());
+    for (const auto &edge : treeEdges)
+    {
+        double &treeLightest = lightest[treeOf ? treeOf[edge.src] : 0];
+        if (edge.weight < treeLightest)
+            treeLightest = edge.weight;
+    }
+    for (size_t tree = 0; tree < results.size(); ++tree)
+    {
+        if (lightest[tree] != std::numeric_limits<double>::infinity())
+            results[tree].shortestDistance = lightest[tree];
+    }
+
+    for (int root = 0; root < numVertices; ++root)
+    {
+        if (visited[root])
+            continue;
+        TreeDistances &result = results[treeOf ? treeOf[root] : 0];
+
+        // First pass from root: subtree sizes and the sum of pairwise distances
+        int end = traverse(root);
+        size_t treeSize = order.size();
+        for (int v : order)
+            visited[v] = true;
+        for (size_t k = treeSize; k-- > 1;)
+        {
+            int v = order[k];
+            subtreeSize[parent[v]] += subtreeSize[v];
+            result.sumOfDistances += parentWeight[v] * static_cast<double>(subtreeSize[v]) *
+                                     static_cast<double>(treeSize - subtreeSize[v]);
+        }
+        result.pairCount += treeSize * (treeSize - 1) / 2;
+
+        // Diameter: the farthest vertex from root is one end, the farthest from it the other
+        if (treeSize > 1)
+        {
+            int other = traverse(end);
+            if (dist[other] > result.longestDistance)
+                result.longestDistance = dist[other];
+        }
+    }
+}
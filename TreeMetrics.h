@@ -0,0 +1,59 @@
+// TreeMetrics.h
+#ifndef TREEMETRICS_H
+#define TREEMETRICS_H
+
+#include <vector>
+#include <cstddef>
+#include "Edge.h"
+
+// Pairwise distance statistics of a tree (or forest); pairs in different trees are ignored
+struct TreeDistances
+{
+    double longestDistance = 0.0;  // Diameter
+    double shortestDistance = 0.0; // Lightest edge
+    double sumOfDistances = 0.0;   // Sum over all connected pairs {u, v}
+    size_t pairCount = 0;          // Number of connected pairs {u, v}
+};
+
+/**
+ * @brief Linear-time distance metrics on a spanning tree or forest.
+ *
+ * On a tree, the path between two vertices is unique, so no shortest-path
+ * search is needed:
+ * - The longest distance is the diameter: the vertex farthest from any start
+ *   is one end of a diameter, and the vertex farthest from it is the other end.
+ * - The shortest distance between two distinct vertices is the lightest edge
+ *   (for non-negative weights).
+ * - An edge that splits its tree into parts of s and n - s vertices lies on the
+ *   paths of exactly s * (n - s) pairs, so the sum of all pairwise distances
+ *   follows from the subtree sizes.
+ *
+ * All three are O(V). An instance keeps its buffers between calls, so a thread
+ * that computes metrics repeatedly does not reallocate them.
+ */
+class TreeMetrics
+{
+public:
+    TreeDistances compute(int numVertices, const std::vector<Edge> &treeEdges);
+    // The same metrics for every tree of a forest; treeOf numbers the tree of every vertex from 0 to numTrees - 1
+    std::vector<TreeDistances> computePerTree(int numVertices, const std::vector<Edge> &treeEdges,
+                                              const std::vector<int> &treeOf, int numTrees);
+
+private:
+    void measure(int numVertices, const std::vector<Edge> &treeEdges, const int *treeOf,
+                 std::vector<TreeDistances> &results);
+    void buildAdjacency(int numVertices, const std::vector<Edge> &treeEdges);
+    int traverse(int start); // Fills dist/parent/order for the tree of start, returns the farthest vertex
+
+    std::vector<size_t> offsets;
+    std::vector<int> neighbors;
+    std::vector<double> weights;
+    std::vector<double> dist;
+    std::vector<int> parent;
+    std::vector<double> parentWeight;
+    std::vector<int> order; // Vertices of the current tree in traversal order
+    std::vector<size_t> subtreeSize;
+    std::vector<bool> visited;
+};
+
+#endif // TREEMETRICS_H
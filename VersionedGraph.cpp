@@ -0,0 +1,23 @@
+// VersionedGraph.cpp
+#include "VersionedGraph.h"
+#include <utility>
+
+std::shared_ptr<const CSRGraph> VersionedGraph::current() const
+{
+    std::shared_ptr<const CSRGraph> snapshot = std::atomic_load(&published);
+    // A writer advances the version before the new snapshot exists, so a
+    // snapshot of an older version is never handed out as the current one
+    if (snapshot && snapshot->getVersion() == latestVersion.load())
+        return snapshot;
+    return nullptr;
+}
+
+void VersionedGraph::advance(uint64_t version)
+{
+    latestVersion.store(version);
+}
+
+void VersionedGraph::publish(std::shared_ptr<const CSRGraph> snapshot)
+{
+    std::atomic_store(&published, std::move(snapshot));
+}
@@ -0,0 +1,43 @@
+// VersionedGraph.h
+#ifndef VERSIONEDGRAPH_H
+#define VERSIONEDGRAPH_H
+
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include "CSRGraph.h"
+
+/**
+ * @brief Publishes immutable, reference-counted snapshots of the server's
+ * graph, one per graph version.
+ *
+ * Writers keep editing the mutable Graph under their own lock and only tell
+ * this object that the version changed; the CSR snapshot of the new version is
+ * published later, by the first reader that needs it. Readers take the
+ * published snapshot with an atomic shared_ptr load and no lock, so any number
+ * of computations can start at once, and each keeps its snapshot alive for as
+ * long as it runs, however many versions are published meanwhile. A writer
+ * never waits for a computation.
+ */
+class VersionedGraph
+{
+public:
+    VersionedGraph() : latestVersion(0) {}
+
+    // Any thread, lock-free: the snapshot of the latest version, or null while
+    // that version has not been published yet or there is no graph at all
+    std::shared_ptr<const CSRGraph> current() const;
+
+    // Writers, serialized by their lock: the graph is now at 'version', which
+    // makes the published snapshot stale
+    void advance(uint64_t version);
+
+    // Writers or readers holding the writers' lock: makes 'snapshot' current
+    void publish(std::shared_ptr<const CSRGraph> snapshot);
+
+private:
+    std::atomic<uint64_t> latestVersion;
+    std::shared_ptr<const CSRGraph> published; // Only accessed through std::atomic_load/atomic_store
+};
+
+#endif // VERSIONEDGRAPH_H
@@ -5,8 +5,101 @@
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include "BulkProtocol.h"
 
-int main()
+/**
+ * @brief Reads a graph file into a bulk upload message (see BulkProtocol.h).
+ *
+ * A file that already starts with the bulk magic is sent as it is. Otherwise
+ * it is read as text: "n m" followed by m lines "src dest weight", with
+ * vertices numbered from 0 like in option 1.
+ */
+static bool loadUpload(const std::string &path, std::vector<char> &message)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return false;
+    std::vector<char> contents(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(contents.data(), contents.size()))
+        return false;
+
+    if (contents.size() >= sizeof(BulkHeader) && isBulkMagic(contents.data()))
+    {
+        message.swap(contents);
+        return true;
+    }
+
+    std::istringstream text(std::string(contents.begin(), contents.end()));
+    BulkHeader header;
+    std::memcpy(header.magic, BULK_MAGIC, sizeof(BULK_MAGIC));
+    if (!(text >> header.numVertices >> header.numEdges) || header.numEdges < 0)
+        return false;
+
+    message.resize(sizeof(BulkHeader) + header.numEdges * sizeof(BulkEdge));
+    std::memcpy(message.data(), &header, sizeof(header));
+    BulkEdge *records = reinterpret_cast<BulkEdge *>(message.data() + sizeof(BulkHeader));
+    for (int64_t i = 0; i < header.numEdges; ++i)
+    {
+        if (!(text >> records[i].src >> records[i].dest >> records[i].weight))
+            return false;
+    }
+    return true;
+}
+
+// Receives server output until the main menu prompt, printing it
+static bool receiveUntilMenu(int sock)
+{
+    char buffer[4096];
+    std::string received;
+    while (received.find("Enter your choice: \n") == std::string::npos)
+    {
+        ssize_t valread = recv(sock, buffer, sizeof(buffer), 0);
+        if (valread <= 0)
+            return false;
+        received.append(buffer, valread);
+        std::cout.write(buffer, valread);
+    }
+    return true;
+}
+
+/**
+ * @brief Sends a graph file as one binary bulk upload and prints the reply.
+ */
+static int uploadGraph(int sock, const std::string &path)
+{
+    std::vector<char> message;
+    if (!loadUpload(path, message))
+    {
+        std::cout << "Cannot read graph file " << path << "\n";
+        return -1;
+    }
+    if (!receiveUntilMenu(sock))
+        return -1;
+
+    size_t sent = 0;
+    while (sent < message.size())
+    {
+        ssize_t n = send(sock, message.data() + sent, message.size() - sent, 0);
+        if (n <= 0)
+        {
+            std::cout << "Upload failed.\n";
+            return -1;
+        }
+        sent += n;
+    }
+
+    if (!receiveUntilMenu(sock))
+        return -1;
+    std::string exitChoice = "5\n";
+    send(sock, exitChoice.c_str(), exitChoice.size(), 0);
+    return 0;
+}
+
+int main(int argc, char *argv[])
 {
     int sock = 0;
     struct sockaddr_in serv_addr;
@@ -33,6 +126,14 @@ int main()
         return -1;
     }
 
+    // "client --upload FILE" sends a whole graph in one binary message
+    if (argc == 3 && std::string(argv[1]) == "--upload")
+    {
+        int result = uploadGraph(sock, argv[2]);
+        close(sock);
+        return result;
+    }
+
     while (true)
     {
         // Clear buffer for next message
@@ -4,28 +4,177 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <cstring>
+#include <cerrno>
+#include <sys/stat.h>
+#include <cstdlib>
+#include <cstdio>
+#include <string>
+#include <sstream>
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
 
 #include "Server.h"
-#include "ActiveObject.h"
+#include "PipelineStage.h"
+#include "Reactor.h"
+#include "Logger.h"
 
 const int PORT = 9034;
 
 using namespace std;
 
-// Define the ThreadPool and ActiveObject pointers
-ThreadPool threadPool(4); // 4 threads in the thread pool, used for computation tasks in the Leader-Follower model
+// Define the ThreadPool and ActiveObject pointers. The pool only runs computation
+// tasks of the Leader-Follower model (client I/O belongs to the reactor), so it
+// gets one thread per core.
+ThreadPool threadPool(std::max(1u, std::thread::hardware_concurrency()));
+
+// Event loop that owns the listening socket and every client socket
+Reactor *reactor;
+
+// Define the pipeline stages, used in the Pipeline model; each runs one or more
+// ActiveObject replicas (see --stage-replicas)
+PipelineStage *stage1Pipeline;
+PipelineStage *stage2Pipeline;
+PipelineStage *stage3Pipeline;
+PipelineStage *stage4Pipeline;
+
+/**
+ * @brief Reads the replica counts of the four pipeline stages: either one
+ * number for all of them or four comma-separated numbers ("1,1,4,1").
+ */
+static bool parseStageReplicas(const char *value)
+{
+    int counts[4];
+    int parsed = sscanf(value, "%d,%d,%d,%d", &counts[0], &counts[1], &counts[2], &counts[3]);
+    if (parsed == 1)
+        counts[1] = counts[2] = counts[3] = counts[0];
+    else if (parsed != 4)
+        return false;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        if (counts[i] < 1)
+            return false;
+        serverConfig.stageReplicas[i] = counts[i];
+    }
+    return true;
+}
 
-// Define the ActiveObject pointers for the pipeline stages, used in the Pipeline model
-ActiveObject *stage1Pipeline;
-ActiveObject *stage2Pipeline;
-ActiveObject *stage3Pipeline;
-ActiveObject *stage4Pipeline;
+// Reads the kernel hints for mapped graph files: "none" or a comma-separated list
+static bool parseMapHints(const string &value)
+{
+    GraphMapHints hints;
+    hints.willNeed = false;
+    stringstream list(value);
+    string hint;
+    while (getline(list, hint, ','))
+    {
+        if (hint == "willneed")
+            hints.willNeed = true;
+        else if (hint == "hugepage")
+            hints.hugePages = true;
+        else if (hint != "none")
+            return false;
+    }
+    serverConfig.mapHints = hints;
+    return true;
+}
 
-int main()
+/**
+ * @brief Reads the startup options into serverConfig.
+ *
+ *   --approx-threshold N   Auto average distance samples above N vertices (default 2000)
+ *   --approx-error E       Sampling stops at relative 95% half-width E (default 0.01)
+ *   --approx-budget S      Sampling stops after S seconds (default 1.0)
+ *   --stage-replicas R     Threads per pipeline stage: N for all, or N1,N2,N3,N4 (default 1)
+ *   --graph-memory MB      Idle named graphs are evicted above MB megabytes in total (default 1024)
+ *   --map-hints H          Hints for mapped graph files: none, or willneed and/or hugepage,
+ *                          comma-separated (default willneed)
+ *   --graph-dir DIR        Directory that options 7 and 8 save and open graph files in, created
+ *                          if missing (default graphs)
+ *   --max-upload-edges N   Binary graph uploads of more than N edges are refused (default 16777216,
+ *                          at most 134217728)
+ *   --log-level L          debug, info, warning, error or off (default info); debug messages
+ *                          are only compiled in with LOG_WITH_DEBUG=1 (see the Makefile)
+ *
+ * @return false on an unknown option or a missing value.
+ */
+static bool parseArguments(int argc, char *argv[])
 {
+    for (int i = 1; i < argc; ++i)
+    {
+        string option = argv[i];
+        if (i + 1 >= argc)
+            return false;
+        const char *value = argv[++i];
+
+        if (option == "--approx-threshold")
+            serverConfig.approximateAboveVertices = atoi(value);
+        else if (option == "--approx-error")
+            serverConfig.approximateTargetError = atof(value);
+        else if (option == "--approx-budget")
+            serverConfig.approximateTimeBudget = atof(value);
+        else if (option == "--stage-replicas")
+        {
+            if (!parseStageReplicas(value))
+                return false;
+        }
+        else if (option == "--map-hints")
+        {
+            if (!parseMapHints(value))
+                return false;
+        }
+        else if (option == "--graph-dir")
+        {
+            serverConfig.graphDirectory = value;
+            if (serverConfig.graphDirectory.empty())
+                return false;
+        }
+        else if (option == "--max-upload-edges")
+        {
+            long long edges = atoll(value);
+            if (edges < 0 || edges > BULK_MAX_EDGES)
+                return false;
+            serverConfig.maxUploadEdges = edges;
+        }
+        else if (option == "--log-level")
+        {
+            LogLevel level;
+            if (!Logger::parseLevel(value, level))
+                return false;
+            Logger::instance().setLevel(level);
+        }
+        else if (option == "--graph-memory")
+        {
+            long megabytes = atol(value);
+            if (megabytes < 0)
+                return false;
+            serverConfig.graphMemoryBudget = static_cast<size_t>(megabytes) << 20;
+        }
+        else
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    if (!parseArguments(argc, argv))
+    {
+        cerr << "Usage: " << argv[0] << " [--approx-threshold N] [--approx-error E] [--approx-budget S] [--stage-replicas R] [--graph-memory MB] [--map-hints H] [--graph-dir DIR] [--max-upload-edges N] [--log-level L]\n";
+        return 1;
+    }
+
+    // Clients save and open graph files only in the graph directory
+    if (mkdir(serverConfig.graphDirectory.c_str(), 0755) < 0 && errno != EEXIST)
+    {
+        perror(serverConfig.graphDirectory.c_str());
+        return 1;
+    }
+
     // Create the server socket to listen for incoming connections
     int serverSocket = socket(AF_INET, SOCK_STREAM, 0);
-    sockaddr_in serverAddr, clientAddr;
+    sockaddr_in serverAddr;
     if (serverSocket < 0)
     {
         perror("socket");
@@ -55,43 +204,37 @@ int main()
         return 1;
     }
 
-    // Start listening for incoming connections. The backlog parameter is set to 5
-    // to allow up to 5 queued connections.
-    if (listen(serverSocket, 5) < 0)
+    // Start listening for incoming connections. The reactor accepts them in
+    // bursts, so the kernel may queue up to SOMAXCONN of them.
+    if (listen(serverSocket, SOMAXCONN) < 0)
     {
         perror("listen");
         return 1;
     }
 
-    cout << "Server is running on port " << PORT << "..." << endl;
+    LOG_INFO("Server is running on port " << PORT << "...");
 
     // Initialize the pipeline stages.
-    stage1Pipeline = new ActiveObject(1);
-    stage2Pipeline = new ActiveObject(2);
-    stage3Pipeline = new ActiveObject(3);
-    stage4Pipeline = new ActiveObject(4);
-
-    // Handle clients by accepting new connections and enqueuing the client handling
-    // task to the thread pool.
-    while (true)
+    stage1Pipeline = new PipelineStage(1, serverConfig.stageReplicas[0]);
+    stage2Pipeline = new PipelineStage(2, serverConfig.stageReplicas[1]);
+    stage3Pipeline = new PipelineStage(3, serverConfig.stageReplicas[2]);
+    stage4Pipeline = new PipelineStage(4, serverConfig.stageReplicas[3]);
+
+    // Handle clients on the reactor thread (this one): it accepts connections,
+    // reads their input line by line and passes every line to processClientInput
+    // with the connection's own session, which hands compute requests to the
+    // pipeline or the thread pool. Binary graph uploads, accepted at the main
+    // menu (acceptsBulkUpload), go to processBulkUpload.
+    try
     {
-        socklen_t clientAddrSize = sizeof(sockaddr_in);
-        int clientSocket = accept(serverSocket, (struct sockaddr *)&clientAddr, &clientAddrSize);
-
-        if (clientSocket < 0)
-        {
-            perror("accept");
-            continue;
-        }
-
-        cout << "Accepted new client connection.\n";
-
-        // Enqueue the client handling task to the thread pool. The client socket
-        // is passed as an argument to the task.
-        threadPool.enqueueTask([clientSocket]()
-                               {
-            int* clientSocketPtr = new int(clientSocket);
-            handleClient((void*)clientSocketPtr); });
+        reactor = new Reactor(serverSocket, openSession, processClientInput, acceptsBulkUpload, processBulkUpload,
+                              closeSession, serverConfig.maxUploadEdges);
+        reactor->run();
+    }
+    catch (const std::runtime_error &error)
+    {
+        LOG_ERROR(error.what());
+        return 1;
     }
 
     // Clean up (this code is unreachable unless the server is terminated)
@@ -100,7 +243,7 @@ int main()
     delete stage3Pipeline;
     delete stage4Pipeline;
 
-    // Close the server socket.
-    close(serverSocket);
+    // Close the server socket and the client sockets.
+    delete reactor;
     return 0;
 }